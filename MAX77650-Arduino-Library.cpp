@@ -37,7 +37,56 @@
 
 #include <MAX77650-Arduino-Library.h>
 
-
+#ifdef ARDUINO
+//Wire object of the selected I2C port of the host µC
+#if  MAX77650_I2C_port == 1
+ #define MAX77650_Wire Wire1
+#elif MAX77650_I2C_port == 2
+ #define MAX77650_Wire Wire2
+#else
+ #define MAX77650_Wire Wire
+#endif
+
+//data bytes fitting into the Wire buffer next to the register address
+#ifdef BUFFER_LENGTH
+ #define MAX77650_BURST_LEN (BUFFER_LENGTH - 1)
+#else
+ #define MAX77650_BURST_LEN 31
+#endif
+#else
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+#endif
+
+unsigned long millis(void){
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec * 1000UL + now.tv_nsec / 1000000UL;
+}
+
+unsigned long micros(void){
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec * 1000000UL + now.tv_nsec / 1000UL;
+}
+
+void delay(unsigned long ms){
+  struct timespec wait = {(time_t)(ms / 1000), (long)(ms % 1000) * 1000000L};
+  nanosleep(&wait, NULL);
+}
+
+void delayMicroseconds(unsigned int us){
+  struct timespec wait = {(time_t)(us / 1000000), (long)(us % 1000000) * 1000L};
+  nanosleep(&wait, NULL);
+}
+#endif
 
 /**********************************************************************
 *@brief MAX77650 - The MAX77650/MAX77651 provide highly-integrated battery charging and 
@@ -62,100 +111,1163 @@
 **********************************************************************/
    
    
+//writable bits of CNFG_CHG_A..CNFG_CHG_I; the remaining bits are reserved and excluded from verification
+static const byte MAX77650_chg_profile_mask[MAX77650_CHG_PROFILE_LEN] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFE, 0xFE, 0xFC, 0xFF};
+
+//***** Transports *****
+
+int MAX77650_transport::begin(void){
+  return 0;
+}
+
+int MAX77650_transport::submit(MAX77650_transfer &transfer){
+  transfer.status = MAX77650_BUS_PENDING;
+  if (transfer.write)
+   transfer.status = write(transfer.addr, transfer.reg, transfer.data, transfer.len);
+  else
+   transfer.status = read(transfer.addr, transfer.reg, transfer.data, transfer.len);
+  if (transfer.done)
+   transfer.done(transfer);
+  return 0;
+}
+
+int MAX77650_transport::recover(void){
+  return MAX77650_ERR_OTHER;
+}
+
+#ifdef ARDUINO
+MAX77650_wire_transport::MAX77650_wire_transport(TwoWire &wire, int sda, int scl) : _wire(&wire), _sda(sda), _scl(scl){
+}
+
+int MAX77650_wire_transport::begin(void){
+  _wire->begin();
+#ifdef WIRE_HAS_TIMEOUT
+  _wire->setWireTimeout(MAX77650_I2C_timeout_us, true);   //a stuck bus ends a transaction with MAX77650_ERR_TIMEOUT
+#endif
+  return MAX77650_OK;
+}
+
+TwoWire& MAX77650_wire_transport::getWire(void) const{
+  return *_wire;
+}
+
+int MAX77650_wire_transport::recover(void){
+  if (_sda >= 0 && _scl >= 0){
+    _wire->end();   //release the pins from the I2C peripheral before bit-banging them
+    //SCL and SDA are driven open-drain: low as output, released as input with pull-up
+    pinMode(_sda, INPUT_PULLUP);
+    pinMode(_scl, INPUT_PULLUP);
+    for (byte i = 0; i < 9 && !digitalRead(_sda); i++){
+      pinMode(_scl, OUTPUT);
+      digitalWrite(_scl, LOW);
+      delayMicroseconds(5);
+      pinMode(_scl, INPUT_PULLUP);
+      delayMicroseconds(5);
+    }
+    //STOP: SDA rises while SCL is high
+    pinMode(_sda, OUTPUT);
+    digitalWrite(_sda, LOW);
+    delayMicroseconds(5);
+    pinMode(_sda, INPUT_PULLUP);
+    delayMicroseconds(5);
+    boolean stuck = !digitalRead(_sda);
+    begin();   //the peripheral takes the pins back only after the STOP
+    return stuck ? MAX77650_ERR_OTHER : MAX77650_OK;   //SDA still held low: not recovered
+  }
+  return begin();
+}
+
+int MAX77650_wire_transport::idle(void){ //checks for a stuck bus before a transaction; SDA is high while the bus is free
+  if (_sda >= 0 && _scl >= 0 && !digitalRead(_sda))
+   return MAX77650_ERR_TIMEOUT;   //reported like a timeout, the driver recovers the bus
+  return MAX77650_OK;
+}
+
+int MAX77650_wire_transport::read(byte addr, byte ADDR, byte *data, byte len){
+  if (idle())
+   return MAX77650_ERR_TIMEOUT;
+  while (len){
+    byte chunk = (len > MAX77650_BURST_LEN) ? MAX77650_BURST_LEN : len;
+    _wire->beginTransmission(addr);
+    _wire->write(ADDR);
+    byte retval = _wire->endTransmission();
+    if (retval)
+     return retval;
+    if (_wire->requestFrom((int)addr, (int)chunk) != chunk)
+     return MAX77650_ERR_NACK_ADDR;
+    for (byte i = 0; i < chunk; i++)
+     *data++ = _wire->read();
+    ADDR += chunk;
+    len -= chunk;
+  }
+  return 0;
+}
+
+int MAX77650_wire_transport::write(byte addr, byte ADDR, const byte *data, byte len){
+  if (idle())
+   return MAX77650_ERR_TIMEOUT;
+  while (len){
+    byte chunk = (len > MAX77650_BURST_LEN) ? MAX77650_BURST_LEN : len;
+    _wire->beginTransmission(addr);
+    _wire->write(ADDR);
+    for (byte i = 0; i < chunk; i++)
+     _wire->write(*data++);
+    byte retval = _wire->endTransmission();
+    if (retval)
+     return retval;
+    ADDR += chunk;
+    len -= chunk;
+  }
+  return 0;
+}
+#endif
+
+#if defined(__linux__) && !defined(ARDUINO)
+MAX77650_linux_transport::MAX77650_linux_transport(const char *device) : _device(device), _fd(-1){
+}
+
+MAX77650_linux_transport::~MAX77650_linux_transport(){
+  end();
+}
+
+int MAX77650_linux_transport::begin(void){
+  if (_fd < 0)
+   _fd = open(_device, O_RDWR);
+  return (_fd < 0) ? MAX77650_ERR_OTHER : MAX77650_OK;
+}
+
+int MAX77650_linux_transport::recover(void){
+  end();
+  return begin();
+}
+
+void MAX77650_linux_transport::end(void){
+  if (_fd >= 0)
+   close(_fd);
+  _fd = -1;
+}
+
+static int MAX77650_linux_error(int err){ //errno of the I2C_RDWR ioctl as MAX77650_error
+  switch (err){
+    case ENXIO: return MAX77650_ERR_NACK_ADDR;
+    case EREMOTEIO: return MAX77650_ERR_NACK_DATA;
+    case ETIMEDOUT: return MAX77650_ERR_TIMEOUT;
+    case EAGAIN: return MAX77650_ERR_ARBITRATION;
+    default: return MAX77650_ERR_OTHER;
+  }
+}
+
+int MAX77650_linux_transport::read(byte addr, byte ADDR, byte *data, byte len){
+  struct i2c_msg msgs[2];
+  struct i2c_rdwr_ioctl_data xfer;
+  if (_fd < 0)
+   return MAX77650_ERR_OTHER;
+  msgs[0].addr = addr;
+  msgs[0].flags = 0;
+  msgs[0].len = 1;
+  msgs[0].buf = &ADDR;
+  msgs[1].addr = addr;
+  msgs[1].flags = I2C_M_RD;
+  msgs[1].len = len;
+  msgs[1].buf = data;
+  xfer.msgs = msgs;
+  xfer.nmsgs = 2;
+  if (ioctl(_fd, I2C_RDWR, &xfer) < 0)
+   return MAX77650_linux_error(errno);
+  return 0;
+}
+
+int MAX77650_linux_transport::write(byte addr, byte ADDR, const byte *data, byte len){
+  byte buf[256];
+  struct i2c_msg msg;
+  struct i2c_rdwr_ioctl_data xfer;
+  if (_fd < 0)
+   return MAX77650_ERR_OTHER;
+  buf[0] = ADDR;
+  memcpy(&buf[1], data, len);
+  msg.addr = addr;
+  msg.flags = 0;
+  msg.len = len + 1;
+  msg.buf = buf;
+  xfer.msgs = &msg;
+  xfer.nmsgs = 1;
+  if (ioctl(_fd, I2C_RDWR, &xfer) < 0)
+   return MAX77650_linux_error(errno);
+  return 0;
+}
+#endif
+
+static byte MAX77650_writable(byte ADDR){ //writable bits of a register
+  if (ADDR == MAX77650_INTM_GLBL_ADDR || ADDR == MAX77650_INT_M_CHG_ADDR)
+   return 0b01111111;
+  if (ADDR == MAX77650_CNFG_GLBL_ADDR)
+   return 0b00111111;   //BOK is read-only
+  if (ADDR == MAX77650_CNFG_GPIO_ADDR)
+   return 0b00011101;   //DI is read-only
+  if (ADDR >= MAX77650_CNFG_CHG_A_ADDR && ADDR <= MAX77650_CNFG_CHG_I_ADDR)
+   return MAX77650_chg_profile_mask[ADDR - MAX77650_CNFG_CHG_A_ADDR];
+  if (ADDR >= MAX77650_CNFG_SBB_TOP_ADDR && ADDR <= MAX77650_CNFG_SBB2_B_ADDR)
+   return 0b11111111;
+  if (ADDR == MAX77650_CNFG_LDO_A_ADDR)
+   return 0b01111111;
+  if (ADDR == MAX77650_CNFG_LDO_B_ADDR)
+   return 0b00001111;
+  if (ADDR >= MAX77650_CNFG_LED0_A_ADDR && ADDR <= MAX77650_CNFG_LED2_B_ADDR)
+   return 0b11111111;
+  if (ADDR == MAX77650_CNFG_LED_TOP_ADDR)
+   return 0b00000001;   //CLK_64_S is read-only
+  return 0;
+}
+
+MAX77650_sim_transport::MAX77650_sim_transport(byte addr, byte cid) : transactions(0), bytes(0), _addr(addr), _cid(cid){
+  reset();
+}
+
+void MAX77650_sim_transport::reset(void){ //reset values of the register definitions; OTP registers start at 0x00
+  for (byte i = 0; i < MAX77650_SIM_REGS; i++)
+   _reg[i] = 0x00;
+  _reg[MAX77650_INTM_GLBL_ADDR] = 0xFF;
+  _reg[MAX77650_INT_M_CHG_ADDR] = 0xFF;
+  _reg[MAX77650_CNFG_GPIO_ADDR] = 0x01;
+  _reg[MAX77650_CID_ADDR] = _cid;
+  _reg[MAX77650_CNFG_CHG_A_ADDR] = 0x0F;
+  _reg[MAX77650_CNFG_CHG_C_ADDR] = 0xF8;
+  _reg[MAX77650_CNFG_CHG_D_ADDR] = 0x10;
+  _reg[MAX77650_CNFG_CHG_E_ADDR] = 0x05;
+  _reg[MAX77650_CNFG_CHG_F_ADDR] = 0x04;
+  _reg[MAX77650_CNFG_CHG_I_ADDR] = 0xF0;
+  for (byte i = MAX77650_CNFG_LED0_A_ADDR; i <= MAX77650_CNFG_LED2_A_ADDR; i++)
+   _reg[i] = 0x04;
+  for (byte i = MAX77650_CNFG_LED0_B_ADDR; i <= MAX77650_CNFG_LED2_B_ADDR; i++)
+   _reg[i] = 0x0F;
+  _reg[MAX77650_CNFG_LED_TOP_ADDR] = 0x0D;
+}
+
+int MAX77650_sim_transport::recover(void){
+  return MAX77650_OK;
+}
+
+byte MAX77650_sim_transport::peek(byte ADDR) const{
+  return (ADDR < MAX77650_SIM_REGS) ? _reg[ADDR] : 0x00;
+}
+
+void MAX77650_sim_transport::poke(byte ADDR, byte data){
+  if (ADDR < MAX77650_SIM_REGS)
+   _reg[ADDR] = data;
+}
+
+int MAX77650_sim_transport::read(byte addr, byte ADDR, byte *data, byte len){
+  if (addr != _addr)
+   return MAX77650_ERR_NACK_ADDR;
+  transactions++;
+  for (byte i = 0; i < len; i++, ADDR++){
+    data[i] = peek(ADDR);
+    if (ADDR == MAX77650_INT_GLBL_ADDR || ADDR == MAX77650_INT_CHG_ADDR || ADDR == MAX77650_ERCFLAG_ADDR)
+     _reg[ADDR] = 0x00;   //read-clear
+  }
+  bytes += len;
+  return 0;
+}
+
+int MAX77650_sim_transport::write(byte addr, byte ADDR, const byte *data, byte len){
+  if (addr != _addr)
+   return MAX77650_ERR_NACK_ADDR;
+  transactions++;
+  for (byte i = 0; i < len; i++, ADDR++){
+    if (ADDR >= MAX77650_SIM_REGS)
+     return MAX77650_ERR_NACK_DATA;
+    byte mask = MAX77650_writable(ADDR);
+    _reg[ADDR] = (_reg[ADDR] & ~mask) | (data[i] & mask);
+    bytes++;
+    if (ADDR == MAX77650_CNFG_GLBL_ADDR && (data[i] & 0b00000011)){
+      reset();    //software cold reset or power-off
+      return 0;
+    }
+  }
+  return 0;
+}
+
+
+//***** Trace recorder *****
+
+static byte MAX77650_leb128(byte *out, unsigned long value){ //encodes value, returns the bytes used (1..5)
+  byte n = 0;
+  do {
+    out[n] = value & 0x7F;
+    value >>= 7;
+    if (value)
+     out[n] |= 0x80;
+    n++;
+  } while (value);
+  return n;
+}
+
+unsigned int MAX77650_trace_decode(const byte *buf, unsigned int len, MAX77650_trace_record &rec){ //Decodes the record at the start of a buffer
+  unsigned int pos = 3;
+  unsigned long *values[2] = {&rec.delta_us, &rec.duration_us};
+  if (len < pos)
+   return 0;
+  rec.write = (buf[0] & MAX77650_TRACE_WRITE) != 0;
+  rec.len = (buf[0] & 0b00111111) + 1;
+  rec.addr = buf[1];
+  rec.reg = buf[2];
+  for (byte v = 0; v < 2; v++){
+    *values[v] = 0;
+    for (byte shift = 0; ; shift += 7){
+      if (pos >= len || shift > 28)
+       return 0;
+      *values[v] |= (unsigned long)(buf[pos] & 0x7F) << shift;
+      if (!(buf[pos++] & 0x80))
+       break;
+    }
+  }
+  if (buf[0] & MAX77650_TRACE_FAILED){
+    if (pos + 1 > len)
+     return 0;
+    rec.status = buf[pos];
+    rec.data = NULL;
+    return pos + 1;
+  }
+  if (pos + rec.len > len)
+   return 0;
+  rec.status = MAX77650_OK;
+  rec.data = &buf[pos];
+  return pos + rec.len;
+}
+
+MAX77650_trace::MAX77650_trace() : records(0), dropped(0), _tail(0), _used(0), _last_us(0){
+}
+
+unsigned int MAX77650_trace::size(unsigned int pos) const{ //size of the record at a position of the ring
+  byte head[13];
+  for (byte i = 0; i < sizeof(head) && i < _used; i++)
+   head[i] = _buf[(pos + i) % MAX77650_TRACE_LEN];
+  unsigned int n = 3;
+  for (byte v = 0; v < 2; v++)
+   while (head[n++] & 0x80);
+  return n + ((head[0] & MAX77650_TRACE_FAILED) ? 1 : (head[0] & 0b00111111) + 1);
+}
+
+void MAX77650_trace::record(byte addr, byte reg, const byte *data, byte len, boolean write, int status, unsigned long start_us, unsigned long duration_us){
+  byte head[13];
+  unsigned int n = 3;
+  if (!len || len > MAX77650_TRACE_MAX_DATA)
+   return;
+  head[0] = (write ? MAX77650_TRACE_WRITE : 0) | (status ? MAX77650_TRACE_FAILED : 0) | (len - 1);
+  head[1] = addr;
+  head[2] = reg;
+  n += MAX77650_leb128(&head[n], records ? start_us - _last_us : 0);
+  n += MAX77650_leb128(&head[n], duration_us);
+  _last_us = start_us;
+  records++;
+  unsigned int total = n + (status ? 1 : len);
+  if (total > MAX77650_TRACE_LEN){
+    dropped++;
+    return;
+  }
+  while (MAX77650_TRACE_LEN - _used < total){   //drop the oldest records
+    unsigned int old = size(_tail);
+    _tail = (_tail + old) % MAX77650_TRACE_LEN;
+    _used -= old;
+    dropped++;
+  }
+  unsigned int pos = (_tail + _used) % MAX77650_TRACE_LEN;
+  for (unsigned int i = 0; i < total; i++){
+    byte b = (i < n) ? head[i] : (status ? (byte)status : data[i - n]);
+    _buf[(pos + i) % MAX77650_TRACE_LEN] = b;
+  }
+  _used += total;
+}
+
+unsigned int MAX77650_trace::available(void) const{
+  return _used;
+}
+
+unsigned int MAX77650_trace::read(byte *out, unsigned int len){
+  unsigned int copied = 0;
+  while (_used){
+    unsigned int n = size(_tail);
+    if (copied + n > len)
+     break;
+    for (unsigned int i = 0; i < n; i++)
+     out[copied++] = _buf[(_tail + i) % MAX77650_TRACE_LEN];
+    _tail = (_tail + n) % MAX77650_TRACE_LEN;
+    _used -= n;
+  }
+  return copied;
+}
+
+void MAX77650_trace::clear(void){
+  _tail = 0;
+  _used = 0;
+}
+
+
+//***** Latency histograms *****
+
+static MAX77650_histogram MAX77650_histograms[MAX77650_LAT_CLASSES];
+
+static void MAX77650_histogram_add(byte cls, unsigned long us){
+#if MAX77650_LATENCY_HISTOGRAMS
+  MAX77650_histogram &h = MAX77650_histograms[cls];
+  byte i = 0;
+  while (i < MAX77650_HIST_BUCKETS - 1 && (us >> (i + 1)))
+   i++;
+  if (h.bucket[i] != 0xFFFF)
+   h.bucket[i]++;
+  h.count++;
+  h.total_us += us;
+  if (us > h.max_us)
+   h.max_us = us;
+#else
+  (void)cls;
+  (void)us;
+#endif
+}
+
+class MAX77650_latency_probe { //records the lifetime of the probe into the histogram of a class
+  public:
+#if MAX77650_LATENCY_HISTOGRAMS
+    MAX77650_latency_probe(byte cls) : _cls(cls), _start(micros()){}
+    ~MAX77650_latency_probe(){
+      MAX77650_histogram_add(_cls, micros() - _start);
+    }
+  private:
+    byte _cls;
+    unsigned long _start;
+#else
+    MAX77650_latency_probe(byte){}
+#endif
+};
+
+const MAX77650_histogram& MAX77650_getHistogram(byte cls){ //Returns the histogram of a class
+  return MAX77650_histograms[(cls < MAX77650_LAT_CLASSES) ? cls : 0];
+}
+
+unsigned long MAX77650_getPercentile_us(byte cls, byte percent){ //Returns the upper bound in µs of the bucket holding the percentile
+  const MAX77650_histogram &h = MAX77650_getHistogram(cls);
+  unsigned long total = 0, sum = 0;
+  for (byte i = 0; i < MAX77650_HIST_BUCKETS; i++)
+   total += h.bucket[i];
+  if (!total)
+   return 0;
+  for (byte i = 0; i < MAX77650_HIST_BUCKETS - 1; i++){
+    sum += h.bucket[i];
+    if (sum * 100 >= total * percent)
+     return (2UL << i) - 1;
+  }
+  return h.max_us;
+}
+
+void MAX77650_clearHistograms(void){ //Clears all histograms
+  memset(MAX77650_histograms, 0, sizeof(MAX77650_histograms));
+}
+
+
+//***** Log *****
+
+#if MAX77650_LOG_LEVEL
+ #define MAX77650_LOG(level, id, a, b) do { if ((level) <= MAX77650_LOG_LEVEL) MAX77650_log_put(level, id, a, b); } while (0)
+#else
+ #define MAX77650_LOG(level, id, a, b) do {} while (0)
+#endif
+
+#if MAX77650_LOG_LEVEL
+static struct {
+  MAX77650_log_entry ring[MAX77650_LOG_LEN];
+  volatile byte head;                     //next entry to take
+  volatile byte used;
+  unsigned int dropped;
+} MAX77650_log;
+
+static const char *const MAX77650_log_formats[MAX77650_MSG_COUNT] = {
+  "init: I2C port %ld, address 0x%02lX",
+  "no PMIC at 0x%02lX, error %ld",
+  "I2C error at register 0x%02lX: %ld",
+  "I2C bus recovered at register 0x%02lX, error %ld",
+  "I2C repetition at register 0x%02lX, attempt %ld",
+  "register 0x%02lX repaired, found 0x%02lX",
+  "IRQ: INT_GLBL 0x%02lX, INT_CHG 0x%02lX",
+  "JEITA zone %ld at %ld dC",
+  "shutdown aborted (dry run %ld) after %ld us",
+  "thermal throttling level %ld (was %ld)",
+  "shutdown: %ld requests dropped, error %ld"
+};
+
+static void MAX77650_log_put(byte level, byte id, long a, long b){
+  if (MAX77650_log.used >= MAX77650_LOG_LEN){
+    MAX77650_log.dropped++;
+    return;
+  }
+  MAX77650_log_entry &entry = MAX77650_log.ring[(MAX77650_log.head + MAX77650_log.used) % MAX77650_LOG_LEN];
+  entry.time = millis();
+  entry.level = level;
+  entry.id = id;
+  entry.arg[0] = a;
+  entry.arg[1] = b;
+  MAX77650_log.used++;
+}
+#endif
+
+boolean MAX77650_log_read(MAX77650_log_entry &entry){ //Takes the oldest entry from the ring
+#if MAX77650_LOG_LEVEL
+  if (!MAX77650_log.used)
+   return false;
+  entry = MAX77650_log.ring[MAX77650_log.head];
+  MAX77650_log.head = (MAX77650_log.head + 1) % MAX77650_LOG_LEN;
+  MAX77650_log.used--;
+  return true;
+#else
+  (void)entry;
+  return false;
+#endif
+}
+
+const char* MAX77650_log_format(byte id){ //Returns the printf format of a message ID
+#if MAX77650_LOG_LEVEL
+  if (id < MAX77650_MSG_COUNT)
+   return MAX77650_log_formats[id];
+#else
+  (void)id;
+#endif
+  return "message %ld %ld";
+}
+
+unsigned int MAX77650_log_dropped(void){ //Returns and clears the number of entries dropped on a full ring
+#if MAX77650_LOG_LEVEL
+  unsigned int dropped = MAX77650_log.dropped;
+  MAX77650_log.dropped = 0;
+  return dropped;
+#else
+  return 0;
+#endif
+}
+
+#ifdef ARDUINO
+void MAX77650_log_print(Print &out){ //Formats and prints all entries of the ring
+  static const char levels[] = "?EWID";
+  MAX77650_log_entry entry;
+  char text[64];
+  while (MAX77650_log_read(entry)){
+    snprintf(text, sizeof(text), MAX77650_log_format(entry.id), entry.arg[0], entry.arg[1]);
+    out.print(entry.time);
+    out.print(' ');
+    out.print(levels[(entry.level < 5) ? entry.level : 0]);
+    out.print(' ');
+    out.println(text);
+  }
+}
+#endif
+
+
+//***** Driver objects *****
+
+#if defined(ARDUINO)
+static MAX77650_wire_transport MAX77650_bus(MAX77650_Wire);
+#elif defined(__linux__)
+static MAX77650_linux_transport MAX77650_bus(MAX77650_I2C_device);
+#else
+static MAX77650_sim_transport MAX77650_bus;
+#endif
+MAX77650 MAX77650_PMIC(MAX77650_bus, MAX77650_ADDR);
+
+//addresses of the cached configuration registers in the order of the shadow
+static const byte MAX77650_register_map[MAX77650_SHADOW_LEN] = {
+  MAX77650_INTM_GLBL_ADDR, MAX77650_INT_M_CHG_ADDR, MAX77650_CNFG_GLBL_ADDR, MAX77650_CNFG_GPIO_ADDR,
+  0x18, 0x19, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F, 0x20,   //CNFG_CHG_A..I
+  0x28, 0x29, 0x2A, 0x2B, 0x2C, 0x2D, 0x2E,               //CNFG_SBB_TOP, CNFG_SBB0_A..CNFG_SBB2_B
+  0x38, 0x39,                                             //CNFG_LDO_A..B
+  0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46                //CNFG_LED0_A..CNFG_LED_TOP
+};
+
+int MAX77650_register_index(byte ADDR){
+  if (ADDR == MAX77650_INTM_GLBL_ADDR || ADDR == MAX77650_INT_M_CHG_ADDR)
+   return ADDR - MAX77650_INTM_GLBL_ADDR;                   //0..1
+  if (ADDR == MAX77650_CNFG_GLBL_ADDR)
+   return 2;
+  if (ADDR == MAX77650_CNFG_GPIO_ADDR)
+   return 3;
+  if (ADDR >= MAX77650_CNFG_CHG_A_ADDR && ADDR <= MAX77650_CNFG_CHG_I_ADDR)
+   return ADDR - MAX77650_CNFG_CHG_A_ADDR + 4;              //4..12
+  if (ADDR >= MAX77650_CNFG_SBB_TOP_ADDR && ADDR <= MAX77650_CNFG_SBB2_B_ADDR)
+   return ADDR - MAX77650_CNFG_SBB_TOP_ADDR + 13;           //13..19
+  if (ADDR >= MAX77650_CNFG_LDO_A_ADDR && ADDR <= MAX77650_CNFG_LDO_B_ADDR)
+   return ADDR - MAX77650_CNFG_LDO_A_ADDR + 20;             //20..21
+  if (ADDR >= MAX77650_CNFG_LED0_A_ADDR && ADDR <= MAX77650_CNFG_LED_TOP_ADDR)
+   return ADDR - MAX77650_CNFG_LED0_A_ADDR + 22;            //22..28
+  return -1;
+}
+
+static byte MAX77650_setting_mask(byte ADDR){ //bits of a register holding settings: writable, but not SFT_RST (a command)
+  return MAX77650_writable(ADDR) & ((ADDR == MAX77650_CNFG_GLBL_ADDR) ? 0b11111100 : 0b11111111);
+}
+
+byte MAX77650_register_address(byte index){
+  return (index < MAX77650_SHADOW_LEN) ? MAX77650_register_map[index] : 0xFF;
+}
+
+byte MAX77650_register_group(byte ADDR){
+  int i = MAX77650_register_index(ADDR);
+  if (i < 0)
+   return MAX77650_GROUP_BUS;
+  if (i < 4)
+   return MAX77650_GROUP_GLOBAL;
+  if (i < 13)
+   return MAX77650_GROUP_CHARGER;
+  if (i < 22)
+   return MAX77650_GROUP_SBB;
+  return MAX77650_GROUP_LED;
+}
+
+static byte MAX77650_register_groups(byte ADDR, byte len){ //lock groups of consecutive registers, one bit per group
+  byte groups = 0;
+  while (len--)
+   groups |= 1 << MAX77650_register_group(ADDR++);
+  return groups;
+}
+
+#define MAX77650_ALL_GROUPS 0b00001111    //groups of all cached registers
+
+class MAX77650_guard { //holds the locks of the groups (bits) for its lifetime: taken ascending, released descending
+  public:
+    MAX77650_guard(MAX77650_lock *lock, byte groups) : _lock(lock), _groups(groups){
+      if (_lock)
+       for (byte i = 0; i < MAX77650_LOCKS; i++)
+        if (_groups & (1 << i))
+         _lock->lock(i);
+    }
+    ~MAX77650_guard(){
+      if (_lock)
+       for (byte i = MAX77650_LOCKS; i-- > 0; )
+        if (_groups & (1 << i))
+         _lock->unlock(i);
+    }
+  private:
+    MAX77650_lock *_lock;
+    byte _groups;
+};
+
+MAX77650::MAX77650(MAX77650_transport &bus, byte address) : _bus(&bus), _addr(address), _part(MAX77650_PART_UNKNOWN), _cid(-1), _retries(MAX77650_I2C_retries), 
+  _backoff_us(MAX77650_I2C_backoff_us), _timeout_us(MAX77650_I2C_timeout_us), _last_error(MAX77650_OK), _bus_stats(), _watchdog(NULL), _lock(NULL), _trace(NULL), _scrub_pos(0), _scrub_budget(MAX77650_SCRUB_BUDGET), _scrub_report(NULL), _scrub_stats(){
+  invalidateShadow();
+}
+
+boolean MAX77650::begin(void){
+  invalidateShadow();
+  _part = MAX77650_PART_UNKNOWN;
+  _cid = -1;
+  if (_bus->begin())
+   return false;
+  int cid = readRegister(MAX77650_CID_ADDR);
+  int glbl = readRegister(MAX77650_STAT_GLBL_ADDR);
+  if (cid < 0 || glbl < 0)
+   return false;
+  _part = (glbl >> 6) & 0b00000011;
+  _cid = cid;
+  return true;
+}
+
+byte MAX77650::getAddress(void) const{
+  return _addr;
+}
+
+byte MAX77650::getPart(void) const{
+  return _part;
+}
+
+int MAX77650::getCID(void) const{
+  return _cid;
+}
+
+unsigned int MAX77650::codeToVoltage(byte ADDR, byte code) const{
+  boolean max77651 = (_part == MAX77650_PART_UNKNOWN) ? PMIC_partnumber == MAX77650_PART_MAX77651 : _part == MAX77650_PART_MAX77651;
+  switch (ADDR){
+    case MAX77650_CNFG_SBB0_A_ADDR: return MAX77650_TV_SBB0_to_mV(code);
+    case MAX77650_CNFG_SBB1_A_ADDR: return max77651 ? MAX77651_TV_SBB1_to_mV(code) : MAX77650_TV_SBB1_to_mV(code);
+    case MAX77650_CNFG_SBB2_A_ADDR: return max77651 ? MAX77651_TV_SBB2_to_mV(code) : MAX77650_TV_SBB2_to_mV(code);
+    case MAX77650_CNFG_LDO_A_ADDR: return MAX77650_TV_LDO_to_mV(code);
+  }
+  return 0;
+}
+
+byte MAX77650::voltageToCode(byte ADDR, unsigned int mV) const{
+  boolean max77651 = (_part == MAX77650_PART_UNKNOWN) ? PMIC_partnumber == MAX77650_PART_MAX77651 : _part == MAX77650_PART_MAX77651;
+  switch (ADDR){
+    case MAX77650_CNFG_SBB0_A_ADDR: return MAX77650_TV_SBB0_mV(mV);
+    case MAX77650_CNFG_SBB1_A_ADDR: return max77651 ? MAX77651_TV_SBB1_mV(mV) : MAX77650_TV_SBB1_mV(mV);
+    case MAX77650_CNFG_SBB2_A_ADDR: return max77651 ? MAX77651_TV_SBB2_mV(mV) : MAX77650_TV_SBB2_mV(mV);
+    case MAX77650_CNFG_LDO_A_ADDR: return MAX77650_TV_LDO_mV(mV);
+  }
+  return 0;
+}
+
+MAX77650_transport& MAX77650::getTransport(void) const{
+  return *_bus;
+}
+
+void MAX77650::setTransport(MAX77650_transport &bus){
+  _bus = &bus;
+  _part = MAX77650_PART_UNKNOWN;
+  _cid = -1;
+  invalidateShadow();
+}
+
+void MAX77650::setRetries(byte retries, unsigned int backoff_us, unsigned long timeout_us){
+  _retries = retries;
+  _backoff_us = backoff_us;
+  _timeout_us = timeout_us;
+}
+
+MAX77650_error MAX77650::getLastError(void) const{
+  return _last_error;
+}
+
+const MAX77650_bus_stats& MAX77650::getBusStats(void) const{
+  return _bus_stats;
+}
+
+void MAX77650::setWatchdog(void (*watchdog)(void)){
+  _watchdog = watchdog;
+}
+
+void MAX77650::setLock(MAX77650_lock *lock){
+  _lock = lock;
+}
+
+MAX77650_lock* MAX77650::getLock(void) const{
+  return _lock;
+}
+
+void MAX77650::setTrace(MAX77650_trace *trace){
+  _trace = trace;
+}
+
+int MAX77650::transfer(boolean write, byte ADDR, byte *data, byte len){ //one transfer with repetitions within the time bound
+  MAX77650_guard guard(_lock, 1 << MAX77650_GROUP_BUS);
+  unsigned long start = micros();
+  unsigned long backoff = _backoff_us;
+  int retval;
+  _bus_stats.transfers++;
+  for (byte attempt = 0; ; attempt++){
+    retval = write ? _bus->write(_addr, ADDR, data, len) : _bus->read(_addr, ADDR, data, len);
+    if (retval == MAX77650_OK || retval == MAX77650_ERR_LENGTH)
+     break;
+    if (retval == MAX77650_ERR_TIMEOUT && _bus->recover() == MAX77650_OK){
+      _bus_stats.recoveries++;
+      MAX77650_LOG(MAX77650_LOG_WARN, MAX77650_MSG_BUS_RECOVERED, ADDR, retval);
+    }
+    if (attempt >= _retries)
+     break;
+    if (_watchdog)
+     _watchdog();
+    unsigned long elapsed = micros() - start;
+    if (elapsed + backoff + elapsed / (attempt + 1) > _timeout_us)
+     break;   //backoff plus an attempt of average duration would end after the bound
+    unsigned long wait = _timeout_us - elapsed;   //remaining budget
+    if (backoff < wait)
+     wait = backoff;
+    if (wait > 16383)
+     wait = 16383;   //longest delay delayMicroseconds keeps accurate
+    delayMicroseconds(wait);
+    if (backoff <= 16383)
+     backoff <<= 1;   //no overflow to a short backoff
+    _bus_stats.retries++;
+    MAX77650_LOG(MAX77650_LOG_DEBUG, MAX77650_MSG_BUS_RETRY, ADDR, attempt + 1);
+  }
+  unsigned long elapsed = micros() - start;
+  if (elapsed > _bus_stats.worst_us)
+   _bus_stats.worst_us = elapsed;
+  if (_trace)
+   _trace->record(_addr, ADDR, data, len, write, retval, start, elapsed);
+  MAX77650_histogram_add(write ? MAX77650_LAT_WRITE : MAX77650_LAT_READ, elapsed);
+  if (retval){
+    _bus_stats.errors++;
+    _last_error = (MAX77650_error)retval;
+    MAX77650_LOG(MAX77650_LOG_ERROR, MAX77650_MSG_BUS_ERROR, ADDR, retval);
+  }
+  return retval;
+}
+
+void MAX77650::cache(byte ADDR, byte data, boolean written){ //written values replace the shadow, read values only fill it
+  int i = MAX77650_register_index(ADDR);
+  if (i < 0)
+   return;
+  if (!written && cached(i))
+   return;
+  if (ADDR == MAX77650_CNFG_GLBL_ADDR)
+   data &= 0b11111100;    //SFT_RST is a command, not a setting
+  _shadow[i] = data;
+  _cached[i] = true;
+}
+
+boolean MAX77650::cached(byte i) const{
+  return _cached[i];
+}
+
+int MAX77650::getShadow(byte ADDR) const{
+  int i = MAX77650_register_index(ADDR);
+  if (i < 0 || !cached(i))
+   return -1;
+  return _shadow[i];
+}
+
+void MAX77650::invalidateShadow(void){
+  MAX77650_guard guard(_lock, MAX77650_ALL_GROUPS);
+  for (byte i = 0; i < MAX77650_SHADOW_LEN; i++)
+   _cached[i] = false;
+}
+
+void MAX77650::forget(byte ADDR, byte len){ //forgets the cached values of consecutive registers
+  while (len--){
+    int i = MAX77650_register_index(ADDR++);
+    if (i >= 0)
+     _cached[i] = false;
+  }
+}
+
+int MAX77650::readRegister(byte ADDR){
+  MAX77650_guard guard(_lock, 1 << MAX77650_register_group(ADDR));
+  byte data;
+  if (transfer(false, ADDR, &data, 1))
+   return -1;
+  cache(ADDR, data, false);
+  return data;
+}
+
+byte MAX77650::writeRegister(byte ADDR, byte data){
+  MAX77650_guard guard(_lock, (ADDR == MAX77650_CNFG_GLBL_ADDR && (data & 0b00000011)) ? MAX77650_ALL_GROUPS : 1 << MAX77650_register_group(ADDR));
+  byte retval = transfer(true, ADDR, &data, 1);
+  if (ADDR == MAX77650_CNFG_GLBL_ADDR && (data & 0b00000011))
+   invalidateShadow();    //software reset or power-off
+  else if (retval)
+   forget(ADDR, 1);       //unknown state after a failed write
+  else
+   cache(ADDR, data, true);
+  return retval;
+}
+
+boolean MAX77650::readBurst(byte ADDR, byte *data, byte len){
+  MAX77650_guard guard(_lock, MAX77650_register_groups(ADDR, len));
+  if (transfer(false, ADDR, data, len))
+   return false;
+  for (byte i = 0; i < len; i++)
+   cache(ADDR + i, data[i], false);
+  return true;
+}
+
+boolean MAX77650::writeBurst(byte ADDR, const byte *data, byte len){
+  MAX77650_guard guard(_lock, MAX77650_register_groups(ADDR, len));
+  if (transfer(true, ADDR, (byte*)data, len)){
+    forget(ADDR, len);    //the PMIC may have taken a part of the burst
+    return false;
+  }
+  for (byte i = 0; i < len; i++)
+   cache(ADDR + i, data[i], true);
+  return true;
+}
+
+boolean MAX77650::updateRegister(byte ADDR, byte mask, byte data){
+  MAX77650_guard guard(_lock, 1 << MAX77650_register_group(ADDR));   //read and write are atomic to other tasks
+  int retval = getShadow(ADDR);
+  if (retval < 0)
+   retval = readRegister(ADDR);
+  if (retval < 0)
+   return false;
+  data = (retval & ~mask) | (data & mask);
+  if (data == retval && getShadow(ADDR) >= 0)
+   return true;   //register holds the value already
+  return writeRegister(ADDR, data) == 0;
+}
+
+int MAX77650::getField(const MAX77650_field &field){
+  int retval = readRegister(field.reg);
+  if (retval < 0)
+   return -1;
+  return (retval >> field.shift) & field.mask;
+}
+
+boolean MAX77650::setField(const MAX77650_field &field, byte data){
+  MAX77650_latency_probe probe(MAX77650_LAT_RMW);
+  MAX77650_guard guard(_lock, 1 << MAX77650_register_group(field.reg));
+  int retval = getShadow(field.reg);
+  if (retval < 0)
+   retval = readRegister(field.reg);
+  if (retval < 0)
+   return false;
+  if (((retval >> field.shift) & field.mask) == data)
+   return true;   //field holds the value already, nothing to write or verify
+  if (!updateRegister(field.reg, field.mask << field.shift, data << field.shift))
+   return false;
+#if MAX77650_VERIFY_WRITES
+  if (getField(field) == data)
+   return true;
+  forget(field.reg, 1);   //the shadow holds the rejected value: the next call has to read and write again
+  return false;
+#else
+  return (data & field.mask) == data;
+#endif
+}
+
+
+//***** Configurations *****
+
+MAX77650_config::MAX77650_config(){
+  for (byte i = 0; i < MAX77650_SHADOW_LEN; i++)
+   value[i] = mask[i] = 0x00;
+}
+
+MAX77650_config& MAX77650_config::setRegister(byte ADDR, byte data, byte bits){
+  int i = MAX77650_register_index(ADDR);
+  if (i >= 0){
+    value[i] = (value[i] & ~bits) | (data & bits);
+    mask[i] |= bits;
+  }
+  return *this;
+}
+
+MAX77650_config& MAX77650_config::set(const MAX77650_field &field, byte data){
+  return setRegister(field.reg, data << field.shift, field.mask << field.shift);
+}
+
+MAX77650_config& MAX77650_config::set(const MAX77650_charger_profile &profile){
+  for (byte i = 0; i < MAX77650_CHG_PROFILE_LEN; i++)
+   setRegister(MAX77650_CNFG_CHG_A_ADDR + i, profile.reg[i]);
+  return *this;
+}
+
+int MAX77650_config::get(const MAX77650_field &field) const{
+  int i = MAX77650_register_index(field.reg);
+  if (i < 0 || ((mask[i] >> field.shift) & field.mask) != field.mask)
+   return -1;
+  return (value[i] >> field.shift) & field.mask;
+}
+
+static byte MAX77650_config_mask(const MAX77650_config &config, byte i){ //configured bits which can be written
+  return config.mask[i] & MAX77650_setting_mask(MAX77650_register_map[i]);
+}
+
+int MAX77650::applyConfig(const MAX77650_config &config){
+  MAX77650_guard guard(_lock, MAX77650_ALL_GROUPS);
+  byte image[MAX77650_SHADOW_LEN];
+  byte dirty[(MAX77650_SHADOW_LEN + 7) / 8] = {0};
+  int bursts = 0;
+  //live image: one burst read per block of consecutive registers, from the first to the last configured one
+  for (byte i = 0; i < MAX77650_SHADOW_LEN; ){
+    byte end = i + 1;
+    while (end < MAX77650_SHADOW_LEN && MAX77650_register_map[end] == MAX77650_register_map[end - 1] + 1)
+     end++;
+    byte first = end, last = i;
+    for (byte j = i; j < end; j++)
+     if (MAX77650_config_mask(config, j)){
+       if (first == end)
+        first = j;
+       last = j;
+     }
+    i = end;
+    if (first == end)
+     continue;
+    if (transfer(false, MAX77650_register_map[first], &image[first], last - first + 1))
+     return -1;
+    for (byte j = first; j <= last; j++){
+      cache(MAX77650_register_map[j], image[j], true);   //the live value replaces a stale shadow
+      byte bits = MAX77650_config_mask(config, j);
+      byte target = (image[j] & ~bits) | (config.value[j] & bits);
+      if (target != image[j]){
+        image[j] = target;
+        dirty[j >> 3] |= (1 << (j & 7));
+      }
+    }
+  }
+  //writes: runs of differing registers; up to MAX77650_CONFIG_GAP unchanged registers are rewritten inside a run
+  for (byte i = 0; i < MAX77650_SHADOW_LEN; i++){
+    if (!(dirty[i >> 3] & (1 << (i & 7))))
+     continue;
+    byte last = i;
+    for (byte j = i + 1; j < MAX77650_SHADOW_LEN && MAX77650_register_map[j] == MAX77650_register_map[j - 1] + 1 && j - last <= MAX77650_CONFIG_GAP + 1; j++)
+     if (dirty[j >> 3] & (1 << (j & 7)))
+      last = j;
+    if (!writeBurst(MAX77650_register_map[i], &image[i], last - i + 1))
+     return -1;
+#if MAX77650_VERIFY_WRITES
+    byte readback[MAX77650_SHADOW_LEN];
+    if (transfer(false, MAX77650_register_map[i], readback, last - i + 1))
+     return -1;
+    for (byte j = i; j <= last; j++)
+     if ((readback[j - i] ^ image[j]) & MAX77650_config_mask(config, j))
+      return -1;
+#endif
+    bursts++;
+    i = last;
+  }
+  return bursts;
+}
+
+
+//***** Snapshots *****
+
+static uint16_t MAX77650_crc16(const byte *data, byte len){ //CRC-16/CCITT, polynomial 0x1021, start 0xFFFF
+  uint16_t crc = 0xFFFF;
+  while (len--){
+    crc ^= (uint16_t)(*data++) << 8;
+    for (byte i = 0; i < 8; i++)
+     crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : (crc << 1);
+  }
+  return crc;
+}
+
+boolean MAX77650_snapshot::valid(void) const{
+  return version == MAX77650_SNAPSHOT_VERSION && crc == MAX77650_crc16(&version, 2 + MAX77650_SHADOW_LEN);
+}
+
+boolean MAX77650::takeSnapshot(MAX77650_snapshot &snapshot){
+  MAX77650_guard guard(_lock, MAX77650_ALL_GROUPS);
+  int cid = readRegister(MAX77650_CID_ADDR);
+  if (cid < 0)
+   return false;
+  //one burst read per block of consecutive registers
+  for (byte i = 0; i < MAX77650_SHADOW_LEN; ){
+    byte end = i + 1;
+    while (end < MAX77650_SHADOW_LEN && MAX77650_register_map[end] == MAX77650_register_map[end - 1] + 1)
+     end++;
+    if (transfer(false, MAX77650_register_map[i], &snapshot.image[i], end - i))
+     return false;
+    for (byte j = i; j < end; j++)
+     cache(MAX77650_register_map[j], snapshot.image[j], true);
+    i = end;
+  }
+  snapshot.version = MAX77650_SNAPSHOT_VERSION;
+  snapshot.cid = cid;
+  snapshot.crc = MAX77650_crc16(&snapshot.version, 2 + MAX77650_SHADOW_LEN); //version, cid and image only: the padding in front of crc is indeterminate
+  return true;
+}
+
+int MAX77650::restoreSnapshot(const MAX77650_snapshot &snapshot){
+  MAX77650_guard guard(_lock, MAX77650_ALL_GROUPS);
+  MAX77650_config config;
+  if (!snapshot.valid() || readRegister(MAX77650_CID_ADDR) != snapshot.cid)
+   return -1;
+  for (byte i = 0; i < MAX77650_SHADOW_LEN; i++)
+   config.setRegister(MAX77650_register_map[i], snapshot.image[i]);
+  return applyConfig(config);
+}
+
+
+//***** Scrubber *****
+
+void MAX77650::setScrubber(byte budget, MAX77650_scrub_callback report){
+  _scrub_budget = budget;
+  _scrub_report = report;
+}
+
+const MAX77650_scrub_stats& MAX77650::getScrubStats(void) const{
+  return _scrub_stats;
+}
+
+int MAX77650::scrub(void){
+  byte live[MAX77650_SHADOW_LEN];
+  byte budget = _scrub_budget;
+  byte visited = 0;
+  int repaired = 0;
+  while (budget && visited < MAX77650_SHADOW_LEN){
+    byte first = _scrub_pos, n = 0;
+    //run of cached registers with consecutive addresses
+    while (n < budget && first + n < MAX77650_SHADOW_LEN && cached(first + n) 
+           && (n == 0 || MAX77650_register_map[first + n] == MAX77650_register_map[first + n - 1] + 1))
+     n++;
+    if (n){
+      //the run lies within one group: no task changes it between comparison and repair
+      MAX77650_guard guard(_lock, 1 << MAX77650_register_group(MAX77650_register_map[first]));
+      if (transfer(false, MAX77650_register_map[first], live, n)){
+        _scrub_stats.errors++;
+        return -1;
+      }
+      for (byte j = 0; j < n; j++){
+        byte ADDR = MAX77650_register_map[first + j];
+        byte expected = _shadow[first + j];
+        byte mask = MAX77650_setting_mask(ADDR);
+        if (!((live[j] ^ expected) & mask))
+         continue;
+        _scrub_stats.mismatches++;
+        if (_scrub_report)
+         _scrub_report(*this, ADDR, expected, live[j]);
+        if (writeRegister(ADDR, (live[j] & ~mask) | (expected & mask)) == 0){
+          _scrub_stats.repairs++;
+          repaired++;
+          MAX77650_LOG(MAX77650_LOG_WARN, MAX77650_MSG_SCRUB_REPAIR, ADDR, live[j]);
+        }
+        else
+         _scrub_stats.errors++;
+      }
+      _scrub_stats.registers += n;
+      budget -= n;
+    }
+    else
+     n = 1;   //not cached, nothing to compare
+    visited += n;
+    _scrub_pos += n;
+    if (_scrub_pos >= MAX77650_SHADOW_LEN){
+      _scrub_pos = 0;
+      _scrub_stats.passes++;
+    }
+  }
+  return repaired;
+}
+
+
+//***** Register access of MAX77650_PMIC *****
+
 boolean MAX77650_init(void){
-   Serial.println(MAX77650_I2C_port);
-   //Init I2C Interface 
-    #if  MAX77650_I2C_port == 0
-	 Wire.begin();
-	#elif MAX77650_I2C_port == 1
-	 Wire1.begin();
-	#elif MAX77650_I2C_port == 2
-	 Wire2.begin();		
-	#else   
-	 Wire.begin();
-	#endif  
+  MAX77650_LOG(MAX77650_LOG_INFO, MAX77650_MSG_INIT, MAX77650_I2C_port, MAX77650_PMIC.getAddress());
+  if (MAX77650_PMIC.begin())
+   return true;
+  MAX77650_LOG(MAX77650_LOG_ERROR, MAX77650_MSG_NO_PMIC, MAX77650_PMIC.getAddress(), MAX77650_PMIC.getLastError());
+  return false;
 }
 
 int MAX77650_read_register(int ADDR){
-  int retval = -1;   
-    #if  MAX77650_I2C_port == 0
-    Wire.beginTransmission(MAX77650_ADDR);
-    Wire.write(ADDR);
-    Wire.endTransmission();
-    Wire.requestFrom(MAX77650_ADDR,1);
-    if (Wire.available()<=1)
-     retval = (Wire.read());  	
-	#elif MAX77650_I2C_port == 1
-    Wire1.beginTransmission(MAX77650_ADDR);
-    Wire1.write(ADDR);
-    Wire1.endTransmission();
-    Wire1.requestFrom(MAX77650_ADDR,1);
-    if (Wire1.available()<=1)
-     retval = (Wire1.read());
-	#elif MAX77650_I2C_port == 2
-    Wire2.beginTransmission(MAX77650_ADDR);
-    Wire2.write(ADDR);
-    Wire2.endTransmission();
-    Wire2.requestFrom(MAX77650_ADDR,1);
-    if (Wire2.available()<=1)
-     retval = (Wire2.read());   
-	#else  
-    Wire.beginTransmission(MAX77650_ADDR);
-    Wire.write(ADDR);
-    Wire.endTransmission();
-    Wire.requestFrom(MAX77650_ADDR,1);
-    if (Wire.available()<=1)
-     retval = (Wire.read());  	
-	#endif 
+  return MAX77650_PMIC.readRegister(ADDR);
 }
 
 byte MAX77650_write_register(int ADDR, int data){
-  int retval = -1;   
-  if (MAX77650_I2C_port == 0){  
-   Wire.beginTransmission(MAX77650_ADDR);
-   Wire.write(ADDR); 
-   Wire.write(data); 
-   Wire.endTransmission();
-  }  
-  if (MAX77650_I2C_port == 1){  
-   Wire1.beginTransmission(MAX77650_ADDR);
-   Wire1.write(ADDR); 
-   Wire1.write(data); 
-   Wire1.endTransmission();
-  }  
-  if (MAX77650_I2C_port == 2){  
-   Wire2.beginTransmission(MAX77650_ADDR);
-   Wire2.write(ADDR); 
-   Wire2.write(data); 
-   Wire2.endTransmission();
-  }
+  return MAX77650_PMIC.writeRegister(ADDR, data);
+}
+
+boolean MAX77650_read_burst(int ADDR, byte *data, byte len){
+  return MAX77650_PMIC.readBurst(ADDR, data, len);
+}
+
+boolean MAX77650_write_burst(int ADDR, const byte *data, byte len){
+  return MAX77650_PMIC.writeBurst(ADDR, data, len);
+}
 
-    #if  MAX77650_I2C_port == 0
-    Wire.beginTransmission(MAX77650_ADDR);
-    Wire.write(ADDR); 
-    Wire.write(data); 
-    Wire.endTransmission();
-	#elif MAX77650_I2C_port == 1
-    Wire1.beginTransmission(MAX77650_ADDR);
-    Wire1.write(ADDR); 
-    Wire1.write(data); 
-    Wire1.endTransmission();
-	#elif MAX77650_I2C_port == 2
-    Wire2.beginTransmission(MAX77650_ADDR);
-    Wire2.write(ADDR); 
-    Wire2.write(data); 
-    Wire2.endTransmission();
-	#else   
-    Wire.beginTransmission(MAX77650_ADDR);
-    Wire.write(ADDR); 
-    Wire.write(data); 
-    Wire.endTransmission();
-	#endif    
-  
-  
+int MAX77650_applyConfig(const MAX77650_config &config){
+  return MAX77650_PMIC.applyConfig(config);
+}
+
+MAX77650_error MAX77650_getLastError(void){
+  return MAX77650_PMIC.getLastError();
+}
+
+byte MAX77650_getPart(void){
+  return MAX77650_PMIC.getPart();
+}
+
+int MAX77650_scrub(void){
+  return MAX77650_PMIC.scrub();
+}
+
+boolean MAX77650_takeSnapshot(MAX77650_snapshot &snapshot){
+  return MAX77650_PMIC.takeSnapshot(snapshot);
+}
+
+int MAX77650_restoreSnapshot(const MAX77650_snapshot &snapshot){
+  return MAX77650_PMIC.restoreSnapshot(snapshot);
 }
 
 boolean MAX77650_getDIDM(void){
+  byte part = MAX77650_PMIC.getPart();
+  if (part != MAX77650_PART_UNKNOWN)
+   return part;
   return ((MAX77650_read_register(MAX77650_STAT_GLBL_ADDR) >> 6) & 0b00000011);   
 }
 
@@ -186,7 +1298,8 @@ byte MAX77650_getERCFLAG(void){ //Returns the ERCFLAG Register 0x04
 }
 
 byte MAX77650_getChipID(void){ // Return Value regaring OTP parts of the MAX77650
-  return (MAX77650_read_register(MAX77650_CID_ADDR) & 0b00001111);      
+  int cid = MAX77650_PMIC.getCID();
+  return (((cid < 0) ? MAX77650_read_register(MAX77650_CID_ADDR) : cid) & 0b00001111);      
 }
 
 boolean MAX77650_VCHGIN_MIN_STAT(void){ //Returns Minimum Input Voltage Regulation Loop Status; Return Value: 0=no event; 1=The minimum CHGIN voltage regulation loop has engaged to regulate VCHGIN >= VCHGIN-MIN
@@ -517,553 +1630,1559 @@ boolean MAX77650_getEN_LED_MSTR(void){ //Returns Master LED Enable Bit
 
 //CID Register
 byte MAX77650_getCID(void){ // Returns the OTP programmed Chip Identification Code
-  return (MAX77650_read_register(MAX77650_CID_ADDR) & 0b00001111); 
+  int cid = MAX77650_PMIC.getCID();
+  return (((cid < 0) ? MAX77650_read_register(MAX77650_CID_ADDR) : cid) & 0b00001111); 
 }
 
 
 //***** Register writes *****
 
 boolean MAX77650_setTV_LDO(byte target_val){ //Sets the LDO Target Output Voltage
-  MAX77650_write_register(MAX77650_CNFG_LDO_A_ADDR,((MAX77650_read_register(MAX77650_CNFG_LDO_A_ADDR) & 0b10000000) | ((target_val & 0b01111111) << 0)));
-  if(MAX77650_getTV_LDO()==target_val)
-   return true;
-  else
-   return false; 
+  return MAX77650_PMIC.setField(MAX77650_FIELD_TV_LDO, target_val);
 }
 
 //LDO Configuration Register B 0x39
 boolean MAX77650_setADE_LDO(byte target_val){ //Sets LDO active-Discharge Enable
-  MAX77650_write_register(MAX77650_CNFG_LDO_B_ADDR,((MAX77650_read_register(MAX77650_CNFG_LDO_B_ADDR) & 0b11110111) | ((target_val & 0b00000001) << 3)));
-  if(MAX77650_getADE_LDO()==target_val)
-   return true;
-  else
-   return false; 
+  return MAX77650_PMIC.setField(MAX77650_FIELD_ADE_LDO, target_val);
 }
 
 boolean MAX77650_setEN_LDO(byte target_val){ //Enable LDO
-  MAX77650_write_register(MAX77650_CNFG_LDO_B_ADDR,((MAX77650_read_register(MAX77650_CNFG_LDO_B_ADDR) & 0b11111000) | ((target_val & 0b00000111) << 0)));
-  if(MAX77650_getEN_LDO()==target_val)
-   return true;
-  else
-   return false; 
+  return MAX77650_PMIC.setField(MAX77650_FIELD_EN_LDO, target_val);
 }
 
 //Charger Configuration Register A 0x18
 boolean MAX77650_setTHM_HOT(byte target_val){ //Returns the VHOT JEITA Temperature Threshold
-  MAX77650_write_register(MAX77650_CNFG_CHG_A_ADDR,((MAX77650_read_register(MAX77650_CNFG_CHG_A_ADDR) & 0b00111111) | ((target_val & 0b00000011) << 6)));
-  if(MAX77650_getTHM_HOT()==target_val)
-   return true;
-  else
-   return false;   
+  return MAX77650_PMIC.setField(MAX77650_FIELD_THM_HOT, target_val);
 }
 boolean MAX77650_setTHM_WARM(byte target_val){ //Returns the VWARM JEITA Temperature Threshold
-  MAX77650_write_register(MAX77650_CNFG_CHG_A_ADDR,((MAX77650_read_register(MAX77650_CNFG_CHG_A_ADDR) & 0b11001111) | ((target_val & 0b00000011) << 4)));
-  if(MAX77650_getTHM_WARM()==target_val)
-   return true;
-  else
-   return false;     
+  return MAX77650_PMIC.setField(MAX77650_FIELD_THM_WARM, target_val);
 }
 boolean MAX77650_setTHM_COOL(byte target_val){ //Returns the VCOOL JEITA Temperature Threshold
-  MAX77650_write_register(MAX77650_CNFG_CHG_A_ADDR,((MAX77650_read_register(MAX77650_CNFG_CHG_A_ADDR) & 0b11110011) | ((target_val & 0b00000011) << 2)));
-  if(MAX77650_getTHM_COOL()==target_val)
-   return true;
-  else
-   return false;       
+  return MAX77650_PMIC.setField(MAX77650_FIELD_THM_COOL, target_val);
 }
 boolean MAX77650_setTHM_COLD(byte target_val){ //Returns the VCOLD JEITA Temperature Threshold
-  MAX77650_write_register(MAX77650_CNFG_CHG_A_ADDR,((MAX77650_read_register(MAX77650_CNFG_CHG_A_ADDR) & 0b11111100) | ((target_val & 0b00000011) << 0)));
-  if(MAX77650_getTHM_COLD()==target_val)
-   return true;
-  else
-   return false;       
+  return MAX77650_PMIC.setField(MAX77650_FIELD_THM_COLD, target_val);
 }
 
 //Charger Configuration Register B 0x19
 boolean MAX77650_setVCHGIN_MIN(byte target_val){ //Returns the Minimum CHGIN regulation voltage (VCHGIN-MIN)
-  MAX77650_write_register(MAX77650_CNFG_CHG_B_ADDR,((MAX77650_read_register(MAX77650_CNFG_CHG_B_ADDR) & 0b00011111) | ((target_val & 0b00000111) << 5)));
-  if(MAX77650_getVCHGIN_MIN()==target_val)
-   return true;
-  else
-   return false;       
+  return MAX77650_PMIC.setField(MAX77650_FIELD_VCHGIN_MIN, target_val);
 }
 boolean MAX77650_setICHGIN_LIM(byte target_val){ //Returns the CHGIN Input Current Limit (ICHGIN-LIM)
-  MAX77650_write_register(MAX77650_CNFG_CHG_B_ADDR,((MAX77650_read_register(MAX77650_CNFG_CHG_B_ADDR) & 0b11100011) | ((target_val & 0b00000111) << 2)));
-  if(MAX77650_getICHGIN_LIM()==target_val)
-   return true;
-  else
-   return false;  
+  return MAX77650_PMIC.setField(MAX77650_FIELD_ICHGIN_LIM, target_val);
 }
 boolean MAX77650_setI_PQ(boolean target_val){ //Returns the prequalification charge current (IPQ) as a percentage of IFAST-CHG
-  MAX77650_write_register(MAX77650_CNFG_CHG_B_ADDR,((MAX77650_read_register(MAX77650_CNFG_CHG_B_ADDR) & 0b11111101) | ((target_val & 0b00000001) << 1)));
-  if(MAX77650_getI_PQ()==target_val)
-   return true;
-  else
-   return false;
+  return MAX77650_PMIC.setField(MAX77650_FIELD_I_PQ, target_val);
 }
 boolean MAX77650_setCHG_EN(boolean target_val){ //Returns Charger Enable
-  MAX77650_write_register(MAX77650_CNFG_CHG_B_ADDR,((MAX77650_read_register(MAX77650_CNFG_CHG_B_ADDR) & 0b11111110) | ((target_val & 0b00000001) << 0)));
-  if(MAX77650_getCHG_EN()==target_val)
-   return true;
-  else
-   return false;
+  return MAX77650_PMIC.setField(MAX77650_FIELD_CHG_EN, target_val);
 }
 
 //Charger Configuration Register C 0x1A
 boolean MAX77650_setCHG_PQ(byte target_val){ //Returns the Battery prequalification voltage threshold (VPQ)
-  MAX77650_write_register(MAX77650_CNFG_CHG_C_ADDR,((MAX77650_read_register(MAX77650_CNFG_CHG_C_ADDR) & 0b00011111) | ((target_val & 0b00000111) << 5)));
-  if(MAX77650_getCHG_PQ()==target_val)
-   return true;
-  else
-   return false;  
+  return MAX77650_PMIC.setField(MAX77650_FIELD_CHG_PQ, target_val);
 }
 boolean MAX77650_setI_TERM(byte target_val){ //Returns the Charger Termination Current (ITERM). I_TERM[1:0] sets the charger termination current as a percentage of the fast charge current IFAST-CHG.
-  MAX77650_write_register(MAX77650_CNFG_CHG_C_ADDR,((MAX77650_read_register(MAX77650_CNFG_CHG_C_ADDR) & 0b11100111) | ((target_val & 0b00000011) << 3)));
-  if(MAX77650_getI_TERM()==target_val)
-   return true;
-  else
-   return false;  
+  return MAX77650_PMIC.setField(MAX77650_FIELD_I_TERM, target_val);
 }
 boolean MAX77650_setT_TOPOFF(byte target_val){ //Returns the Topoff timer value (tTO)
-  MAX77650_write_register(MAX77650_CNFG_CHG_C_ADDR,((MAX77650_read_register(MAX77650_CNFG_CHG_C_ADDR) & 0b11111000) | ((target_val & 0b00000111) << 0)));
-  if(MAX77650_getT_TOPOFF()==target_val)
-   return true;
-  else
-   return false;  
+  return MAX77650_PMIC.setField(MAX77650_FIELD_T_TOPOFF, target_val);
 }
 
 //Charger Configuration Register D 0x1B
 boolean MAX77650_setTJ_REG(byte target_val){ //Returns the die junction temperature regulation point, TJ-REG
-  MAX77650_write_register(MAX77650_CNFG_CHG_D_ADDR,((MAX77650_read_register(MAX77650_CNFG_CHG_D_ADDR) & 0b00011111) | ((target_val & 0b00000111) << 5)));
-  if(MAX77650_getTJ_REG()==target_val)
-   return true;
-  else
-   return false;  
+  return MAX77650_PMIC.setField(MAX77650_FIELD_TJ_REG, target_val);
 }
 boolean MAX77650_setVSYS_REG(byte target_val){ //Returns the System voltage regulation (VSYS-REG)
-  MAX77650_write_register(MAX77650_CNFG_CHG_D_ADDR,((MAX77650_read_register(MAX77650_CNFG_CHG_D_ADDR) & 0b11100000) | ((target_val & 0b00011111) << 0)));
-  if(MAX77650_getVSYS_REG()==target_val)
-   return true;
-  else
-   return false;  
+  return MAX77650_PMIC.setField(MAX77650_FIELD_VSYS_REG, target_val);
 }
 
 //Charger Configuration Register E 0x1C
 boolean MAX77650_setCHG_CC(byte target_val){ //Returns the fast-charge constant current value, IFAST-CHG.
-  MAX77650_write_register(MAX77650_CNFG_CHG_E_ADDR,((MAX77650_read_register(MAX77650_CNFG_CHG_E_ADDR) & 0b00000011) | ((target_val & 0b00111111) << 2)));
-  if(MAX77650_getCHG_CC()==target_val)
-   return true;
-  else
-   return false;  
+  return MAX77650_PMIC.setField(MAX77650_FIELD_CHG_CC, target_val);
 }
 boolean MAX77650_setT_FAST_CHG(byte target_val){ //Returns the fast-charge safety timer, tFC.
-  MAX77650_write_register(MAX77650_CNFG_CHG_E_ADDR,((MAX77650_read_register(MAX77650_CNFG_CHG_E_ADDR) & 0b11111100) | ((target_val & 0b00000011) << 0)));
-  if(MAX77650_getT_FAST_CHG()==target_val)
-   return true;
-  else
-   return false;  
+  return MAX77650_PMIC.setField(MAX77650_FIELD_T_FAST_CHG, target_val);
 }
 
 //Charger Configuration Register F 0x1D
 boolean MAX77650_setCHG_CC_JEITA(byte target_val){ //Returns the IFAST-CHG_JEITA for when the battery is either cool or warm as defined by the TCOOL and TWARM temperature thresholds. This register is a don't care if the battery temperature is normal.
-  MAX77650_write_register(MAX77650_CNFG_CHG_F_ADDR,((MAX77650_read_register(MAX77650_CNFG_CHG_F_ADDR) & 0b00000011) | ((target_val & 0b00111111) << 2)));
-  if(MAX77650_getCHG_CC_JEITA()==target_val)
-   return true;
-  else
-   return false;    
+  return MAX77650_PMIC.setField(MAX77650_FIELD_CHG_CC_JEITA, target_val);
 }
 boolean MAX77650_setTHM_EN(boolean target_val){ //Returns the Thermistor enable bit
-  MAX77650_write_register(MAX77650_CNFG_CHG_F_ADDR,((MAX77650_read_register(MAX77650_CNFG_CHG_F_ADDR) & 0b11111101) | ((target_val & 0b00000001) << 1)));
-  if(MAX77650_getTHM_EN()==target_val)
-   return true;
-  else
-   return false;    
+  return MAX77650_PMIC.setField(MAX77650_FIELD_THM_EN, target_val);
 }
 
 //Charger Configuration Register G 0x1E
 boolean MAX77650_setCHG_CV(byte target_val){ //Returns the fast-charge battery regulation voltage, VFAST-CHG.
-  MAX77650_write_register(MAX77650_CNFG_CHG_G_ADDR,((MAX77650_read_register(MAX77650_CNFG_CHG_G_ADDR) & 0b00000011) | ((target_val & 0b00111111) << 2)));
-  if(MAX77650_getCHG_CV()==target_val)
-   return true;
-  else
-   return false;    
+  return MAX77650_PMIC.setField(MAX77650_FIELD_CHG_CV, target_val);
 }
 boolean MAX77650_setUSBS(boolean target_val){ //this bit places CHGIN in USB suspend mode
-  MAX77650_write_register(MAX77650_CNFG_CHG_G_ADDR,((MAX77650_read_register(MAX77650_CNFG_CHG_G_ADDR) & 0b11111101) | ((target_val & 0b00000001) << 1)));
-  if(MAX77650_getUSBS()==target_val)
-   return true;
-  else
-   return false;    
+  return MAX77650_PMIC.setField(MAX77650_FIELD_USBS, target_val);
 }
 
 //Charger Configuration Register H 0x1F
 boolean MAX77650_setCHG_CV_JEITA(byte target_val){ //Returns the modified VFAST-CHG for when the battery is either cool or warm as defined by the TCOOL and TWARM temperature thresholds. This register is a don't care if the battery temperature is normal.
-  MAX77650_write_register(MAX77650_CNFG_CHG_H_ADDR,((MAX77650_read_register(MAX77650_CNFG_CHG_H_ADDR) & 0b00000011) | ((target_val & 0b00111111) << 2)));
-  if(MAX77650_getCHG_CV_JEITA()==target_val)
-   return true;
-  else
-   return false;    
+  return MAX77650_PMIC.setField(MAX77650_FIELD_CHG_CV_JEITA, target_val);
 }
 
 //Charger Configuration Register I 0x20
 boolean MAX77650_setIMON_DISCHG_SCALE(byte target_val){ //Returns the Selects the battery discharge current full-scale current value This 4-bit configuration starts at 7.5mA and ends at 300mA.
-  MAX77650_write_register(MAX77650_CNFG_CHG_I_ADDR,((MAX77650_read_register(MAX77650_CNFG_CHG_I_ADDR) & 0b00001111) | ((target_val & 0b00001111) << 4)));
-  if(MAX77650_getIMON_DISCHG_SCALE()==target_val)
-   return true;
-  else
-   return false;    
+  return MAX77650_PMIC.setField(MAX77650_FIELD_IMON_DISCHG_SCALE, target_val);
 }
 boolean MAX77650_setMUX_SEL(byte target_val){ //Returns the analog channel to connect to AMUX configuration
-  MAX77650_write_register(MAX77650_CNFG_CHG_I_ADDR,((MAX77650_read_register(MAX77650_CNFG_CHG_I_ADDR) & 0b11110000) | ((target_val & 0b00001111) << 0)));
-  if(MAX77650_getMUX_SEL()==target_val)
-   return true;
-  else
-   return false;    
+  return MAX77650_PMIC.setField(MAX77650_FIELD_MUX_SEL, target_val);
 }
 
 //SIMO Buck-Boost Global Configuration Register 0x28
 boolean MAX77650_setMRT_OTP(boolean target_val){ //Returns Manual Reset Time Configuration
-  MAX77650_write_register(MAX77650_CNFG_SBB_TOP_ADDR,((MAX77650_read_register(MAX77650_CNFG_SBB_TOP_ADDR) & 0b10111111) | ((target_val & 0b00000001) << 6)));
-  if(MAX77650_getMRT_OTP()==target_val)
-   return true;
-  else
-   return false;    
+  return MAX77650_PMIC.setField(MAX77650_FIELD_MRT_OTP, target_val);
 }
 boolean MAX77650_setSBIA_LPM_DEF(boolean target_val){ //Returns Default voltage of the SBIA_LPM bit
-  MAX77650_write_register(MAX77650_CNFG_SBB_TOP_ADDR,((MAX77650_read_register(MAX77650_CNFG_SBB_TOP_ADDR) & 0b11011111) | ((target_val & 0b00000001) << 5)));
-  if(MAX77650_getSBIA_LPM_DEF()==target_val)
-   return true;
-  else
-   return false;  
+  return MAX77650_PMIC.setField(MAX77650_FIELD_SBIA_LPM_DEF, target_val);
 }
 boolean MAX77650_setDBNC_nEN_DEF(boolean target_val){ //Returns Default Value of the DBNC_nEN bit
-  MAX77650_write_register(MAX77650_CNFG_SBB_TOP_ADDR,((MAX77650_read_register(MAX77650_CNFG_SBB_TOP_ADDR) & 0b11101111) | ((target_val & 0b00000001) << 4)));
-  if(MAX77650_getDBNC_nEN_DEF()==target_val)
-   return true;
-  else
-   return false;  
+  return MAX77650_PMIC.setField(MAX77650_FIELD_DBNC_nEN_DEF, target_val);
 }
 boolean MAX77650_setDRV_SBB(byte target_val){ //Returns the SIMO Buck-Boost (all channels) Drive Strength Trim.
-  MAX77650_write_register(MAX77650_CNFG_SBB_TOP_ADDR,((MAX77650_read_register(MAX77650_CNFG_SBB_TOP_ADDR) & 0b11111100) | ((target_val & 0b00000011) << 0)));
-  if(MAX77650_getDRV_SBB()==target_val)
-   return true;
-  else
-   return false;  
+  return MAX77650_PMIC.setField(MAX77650_FIELD_DRV_SBB, target_val);
 }
 
 //SIMO Buck-Boost 0 Configuration Register A 0x29
 boolean MAX77650_setIP_SBB0(byte target_val){ //Returns the SIMO Buck-Boost Channel 0 Peak Current Limit
-  MAX77650_write_register(MAX77650_CNFG_SBB0_A_ADDR,((MAX77650_read_register(MAX77650_CNFG_SBB0_A_ADDR) & 0b00111111) | ((target_val & 0b00000011) << 6)));
-  if(MAX77650_getIP_SBB0()==target_val)
-   return true;
-  else
-   return false;  
+  return MAX77650_PMIC.setField(MAX77650_FIELD_IP_SBB0, target_val);
 }
 boolean MAX77650_setTV_SBB0(byte target_val){ //Returns the SIMO Buck-Boost Channel 0 Target Output Voltage
-  MAX77650_write_register(MAX77650_CNFG_SBB0_A_ADDR,((MAX77650_read_register(MAX77650_CNFG_SBB0_A_ADDR) & 0b11000000) | ((target_val & 0b00111111) << 0)));
-  if(MAX77650_getTV_SBB0()==target_val)
-   return true;
-  else
-   return false;    
+  return MAX77650_PMIC.setField(MAX77650_FIELD_TV_SBB0, target_val);
 }
 
 //SIMO Buck-Boost 0 Configuration Register B 0x2A
 boolean MAX77650_setADE_SBB0(boolean target_val){ //Returns SIMO Buck-Boost Channel 0 Active-Discharge Enable
-  MAX77650_write_register(MAX77650_CNFG_SBB0_B_ADDR,((MAX77650_read_register(MAX77650_CNFG_SBB0_B_ADDR) & 0b11110111) | ((target_val & 0b00000001) << 3)));
-  if(MAX77650_getADE_SBB0()==target_val)
-   return true;
-  else
-   return false;    
+  return MAX77650_PMIC.setField(MAX77650_FIELD_ADE_SBB0, target_val);
 }
 boolean MAX77650_setEN_SBB0(byte target_val){ //Returns the Enable Control for SIMO Buck-Boost Channel 0.
-  MAX77650_write_register(MAX77650_CNFG_SBB0_B_ADDR,((MAX77650_read_register(MAX77650_CNFG_SBB0_B_ADDR) & 0b11111000) | ((target_val & 0b00000111) << 0)));
-  if(MAX77650_getEN_SBB0()==target_val)
-   return true;
-  else
-   return false;    
+  return MAX77650_PMIC.setField(MAX77650_FIELD_EN_SBB0, target_val);
 }
 
 //SIMO Buck-Boost 1 Configuration Register A 0x2B
 boolean MAX77650_setIP_SBB1(byte target_val){ //Returns the SIMO Buck-Boost Channel 1 Peak Current Limit
-  MAX77650_write_register(MAX77650_CNFG_SBB1_A_ADDR,((MAX77650_read_register(MAX77650_CNFG_SBB1_A_ADDR) & 0b00111111) | ((target_val & 0b00000011) << 6)));
-  if(MAX77650_getIP_SBB1()==target_val)
-   return true;
-  else
-   return false;  
+  return MAX77650_PMIC.setField(MAX77650_FIELD_IP_SBB1, target_val);
 }
 boolean MAX77650_setTV_SBB1(byte target_val){ //Returns the SIMO Buck-Boost Channel 1 Target Output Voltage
-  MAX77650_write_register(MAX77650_CNFG_SBB1_A_ADDR,((MAX77650_read_register(MAX77650_CNFG_SBB1_A_ADDR) & 0b11000000) | ((target_val & 0b00111111) << 0)));
-  if(MAX77650_getTV_SBB1()==target_val)
-   return true;
-  else
-   return false;    
+  return MAX77650_PMIC.setField(MAX77650_FIELD_TV_SBB1, target_val);
 }
 
 //SIMO Buck-Boost 1 Configuration Register B 0x2C
 boolean MAX77650_setADE_SBB1(boolean target_val){ //Returns SIMO Buck-Boost Channel 1 Active-Discharge Enable
-  MAX77650_write_register(MAX77650_CNFG_SBB1_B_ADDR,((MAX77650_read_register(MAX77650_CNFG_SBB1_B_ADDR) & 0b11110111) | ((target_val & 0b00000001) << 3)));
-  if(MAX77650_getADE_SBB1()==target_val)
-   return true;
-  else
-   return false;    
+  return MAX77650_PMIC.setField(MAX77650_FIELD_ADE_SBB1, target_val);
 }
 boolean MAX77650_setEN_SBB1(byte target_val){ //Returns the Enable Control for SIMO Buck-Boost Channel 1.
-  MAX77650_write_register(MAX77650_CNFG_SBB1_B_ADDR,((MAX77650_read_register(MAX77650_CNFG_SBB1_B_ADDR) & 0b11111000) | ((target_val & 0b00000111) << 0)));
-  if(MAX77650_getEN_SBB1()==target_val)
-   return true;
-  else
-   return false;    
+  return MAX77650_PMIC.setField(MAX77650_FIELD_EN_SBB1, target_val);
 }
 
 //SIMO Buck-Boost 2 Configuration Register A 0x2D
 boolean MAX77650_setIP_SBB2(byte target_val){ //Returns the SIMO Buck-Boost Channel 2 Peak Current Limit
-  MAX77650_write_register(MAX77650_CNFG_SBB2_A_ADDR,((MAX77650_read_register(MAX77650_CNFG_SBB2_A_ADDR) & 0b00111111) | ((target_val & 0b00000011) << 6)));
-  if(MAX77650_getIP_SBB2()==target_val)
-   return true;
-  else
-   return false;  
+  return MAX77650_PMIC.setField(MAX77650_FIELD_IP_SBB2, target_val);
 }
 boolean MAX77650_setTV_SBB2(byte target_val){ //Returns the SIMO Buck-Boost Channel 2 Target Output Voltage
-  MAX77650_write_register(MAX77650_CNFG_SBB2_A_ADDR,((MAX77650_read_register(MAX77650_CNFG_SBB2_A_ADDR) & 0b11000000) | ((target_val & 0b00111111) << 0)));
-  if(MAX77650_getTV_SBB2()==target_val)
-   return true;
-  else
-   return false;    
+  return MAX77650_PMIC.setField(MAX77650_FIELD_TV_SBB2, target_val);
 }
 
 //SIMO Buck-Boost 2 Configuration Register B 0x2E
 boolean MAX77650_setADE_SBB2(boolean target_val){ //Returns SIMO Buck-Boost Channel 2 Active-Discharge Enable
-  MAX77650_write_register(MAX77650_CNFG_SBB2_B_ADDR,((MAX77650_read_register(MAX77650_CNFG_SBB2_B_ADDR) & 0b11110111) | ((target_val & 0b00000001) << 3)));
-  if(MAX77650_getADE_SBB2()==target_val)
-   return true;
-  else
-   return false;    
+  return MAX77650_PMIC.setField(MAX77650_FIELD_ADE_SBB2, target_val);
 }
 boolean MAX77650_setEN_SBB2(byte target_val){ //Returns the Enable Control for SIMO Buck-Boost Channel 2.
-  MAX77650_write_register(MAX77650_CNFG_SBB2_B_ADDR,((MAX77650_read_register(MAX77650_CNFG_SBB2_B_ADDR) & 0b11111000) | ((target_val & 0b00000111) << 0)));
-  if(MAX77650_getEN_SBB2()==target_val)
-   return true;
-  else
-   return false;    
+  return MAX77650_PMIC.setField(MAX77650_FIELD_EN_SBB2, target_val);
 }
 
 //LED related registers
 boolean MAX77650_setEN_LED_MSTR(boolean target_val){ //Returns Master LED Enable Bit
-  MAX77650_write_register(MAX77650_CNFG_LED_TOP_ADDR,((MAX77650_read_register(MAX77650_CNFG_LED_TOP_ADDR) & 0b11111110) | ((target_val & 0b00000001) << 0)));
-  if(MAX77650_getEN_LED_MSTR()==target_val)
-   return true;
-  else
-   return false;    
+  return MAX77650_PMIC.setField(MAX77650_FIELD_EN_LED_MSTR, target_val);
 }
 
 //Register LED0
 boolean MAX77650_setLED_FS0(byte target_val){ //Returns LED0 Full Scale Range
-  MAX77650_write_register(MAX77650_CNFG_LED0_A_ADDR,((MAX77650_read_register(MAX77650_CNFG_LED0_A_ADDR) & 0b00111111) | ((target_val & 0b00000011) << 6)));
-  if(MAX77650_getLED_FS0()==target_val)
-   return true;
-  else
-   return false;    
+  return MAX77650_PMIC.setField(MAX77650_FIELD_LED_FS0, target_val);
 }
 boolean MAX77650_setINV_LED0(boolean target_val){ //Returns LED0 Invert
-  MAX77650_write_register(MAX77650_CNFG_LED0_A_ADDR,((MAX77650_read_register(MAX77650_CNFG_LED0_A_ADDR) & 0b11011111) | ((target_val & 0b00000001) << 5)));
-  if(MAX77650_getINV_LED0()==target_val)
-   return true;
-  else
-   return false;    
+  return MAX77650_PMIC.setField(MAX77650_FIELD_INV_LED0, target_val);
 }
 boolean MAX77650_setBRT_LED0(byte target_val){ //Returns LED0 Brightness Control
-  MAX77650_write_register(MAX77650_CNFG_LED0_A_ADDR,((MAX77650_read_register(MAX77650_CNFG_LED0_A_ADDR) & 0b11100000) | ((target_val & 0b00011111) << 0)));
-  if(MAX77650_getBRT_LED0()==target_val)
-   return true;
-  else
-   return false;    
+  return MAX77650_PMIC.setField(MAX77650_FIELD_BRT_LED0, target_val);
 }
 boolean MAX77650_setP_LED0(byte target_val){ //Returns LED0 Period Settings
-  MAX77650_write_register(MAX77650_CNFG_LED0_B_ADDR,((MAX77650_read_register(MAX77650_CNFG_LED0_B_ADDR) & 0b00001111) | ((target_val & 0b00001111) << 4)));
-  if(MAX77650_getP_LED0()==target_val)
-   return true;
-  else
-   return false;    
+  return MAX77650_PMIC.setField(MAX77650_FIELD_P_LED0, target_val);
 }
 boolean MAX77650_setD_LED0(byte target_val){ //Returns LED0 On Duty-Cycle Settings
-  MAX77650_write_register(MAX77650_CNFG_LED0_B_ADDR,((MAX77650_read_register(MAX77650_CNFG_LED0_B_ADDR) & 0b11110000) | ((target_val & 0b00001111) << 0)));
-  if(MAX77650_getD_LED0()==target_val)
-   return true;
-  else
-   return false;    
+  return MAX77650_PMIC.setField(MAX77650_FIELD_D_LED0, target_val);
 }
 
 //Register LED1
 boolean MAX77650_setLED_FS1(byte target_val){ //Returns LED1 Full Scale Range
-  MAX77650_write_register(MAX77650_CNFG_LED1_A_ADDR,((MAX77650_read_register(MAX77650_CNFG_LED1_A_ADDR) & 0b00111111) | ((target_val & 0b00000011) << 6)));
-  if(MAX77650_getLED_FS1()==target_val)
-   return true;
-  else
-   return false;    
+  return MAX77650_PMIC.setField(MAX77650_FIELD_LED_FS1, target_val);
 }
 boolean MAX77650_setINV_LED1(boolean target_val){ //Returns LED1 Invert
-  MAX77650_write_register(MAX77650_CNFG_LED1_A_ADDR,((MAX77650_read_register(MAX77650_CNFG_LED1_A_ADDR) & 0b11011111) | ((target_val & 0b00000001) << 5)));
-  if(MAX77650_getINV_LED1()==target_val)
-   return true;
-  else
-   return false;    
+  return MAX77650_PMIC.setField(MAX77650_FIELD_INV_LED1, target_val);
 }
 boolean MAX77650_setBRT_LED1(byte target_val){ //Returns LED1 Brightness Control
-  MAX77650_write_register(MAX77650_CNFG_LED1_A_ADDR,((MAX77650_read_register(MAX77650_CNFG_LED1_A_ADDR) & 0b11100000) | ((target_val & 0b00011111) << 0)));
-  if(MAX77650_getBRT_LED1()==target_val)
-   return true;
-  else
-   return false;    
+  return MAX77650_PMIC.setField(MAX77650_FIELD_BRT_LED1, target_val);
 }
 boolean MAX77650_setP_LED1(byte target_val){ //Returns LED1 Period Settings
-  MAX77650_write_register(MAX77650_CNFG_LED1_B_ADDR,((MAX77650_read_register(MAX77650_CNFG_LED1_B_ADDR) & 0b00001111) | ((target_val & 0b00001111) << 4)));
-  if(MAX77650_getP_LED1()==target_val)
-   return true;
-  else
-   return false;    
+  return MAX77650_PMIC.setField(MAX77650_FIELD_P_LED1, target_val);
 }
 boolean MAX77650_setD_LED1(byte target_val){ //Returns LED1 On Duty-Cycle Settings
-  MAX77650_write_register(MAX77650_CNFG_LED1_B_ADDR,((MAX77650_read_register(MAX77650_CNFG_LED1_B_ADDR) & 0b11110000) | ((target_val & 0b00001111) << 0)));
-  if(MAX77650_getD_LED1()==target_val)
-   return true;
-  else
-   return false;    
+  return MAX77650_PMIC.setField(MAX77650_FIELD_D_LED1, target_val);
 }
 
 //Register LED2
 boolean MAX77650_setLED_FS2(byte target_val){ //Returns LED2 Full Scale Range
-  MAX77650_write_register(MAX77650_CNFG_LED2_A_ADDR,((MAX77650_read_register(MAX77650_CNFG_LED2_A_ADDR) & 0b00111111) | ((target_val & 0b00000011) << 6)));
-  if(MAX77650_getLED_FS2()==target_val)
-   return true;
-  else
-   return false;    
+  return MAX77650_PMIC.setField(MAX77650_FIELD_LED_FS2, target_val);
 }
 boolean MAX77650_setINV_LED2(boolean target_val){ //Returns LED2 Invert
-  MAX77650_write_register(MAX77650_CNFG_LED2_A_ADDR,((MAX77650_read_register(MAX77650_CNFG_LED2_A_ADDR) & 0b11011111) | ((target_val & 0b00000001) << 5)));
-  if(MAX77650_getINV_LED2()==target_val)
-   return true;
-  else
-   return false;    
+  return MAX77650_PMIC.setField(MAX77650_FIELD_INV_LED2, target_val);
 }
 boolean MAX77650_setBRT_LED2(byte target_val){ //Returns LED2 Brightness Control
-  MAX77650_write_register(MAX77650_CNFG_LED2_A_ADDR,((MAX77650_read_register(MAX77650_CNFG_LED2_A_ADDR) & 0b11100000) | ((target_val & 0b00011111) << 0)));
-  if(MAX77650_getBRT_LED2()==target_val)
-   return true;
-  else
-   return false;    
+  return MAX77650_PMIC.setField(MAX77650_FIELD_BRT_LED2, target_val);
 }
 boolean MAX77650_setP_LED2(byte target_val){ //Returns LED2 Period Settings
-  MAX77650_write_register(MAX77650_CNFG_LED2_B_ADDR,((MAX77650_read_register(MAX77650_CNFG_LED2_B_ADDR) & 0b00001111) | ((target_val & 0b00001111) << 4)));
-  if(MAX77650_getP_LED2()==target_val)
-   return true;
-  else
-   return false;    
+  return MAX77650_PMIC.setField(MAX77650_FIELD_P_LED2, target_val);
 }
 boolean MAX77650_setD_LED2(byte target_val){ //Returns LED2 On Duty-Cycle Settings
-  MAX77650_write_register(MAX77650_CNFG_LED2_B_ADDR,((MAX77650_read_register(MAX77650_CNFG_LED2_B_ADDR) & 0b11110000) | ((target_val & 0b00001111) << 0)));
-  if(MAX77650_getD_LED2()==target_val)
-   return true;
-  else
-   return false;    
+  return MAX77650_PMIC.setField(MAX77650_FIELD_D_LED2, target_val);
 }
 
 //Global Configuration register 0x10
 boolean MAX77650_setBOK(boolean target_val){ //Returns Main Bias Okay Status Bit
-  MAX77650_write_register(MAX77650_CNFG_GLBL_ADDR,((MAX77650_read_register(MAX77650_CNFG_GLBL_ADDR) & 0b10111111) | ((target_val & 0b00000001) << 6)));
-  if(MAX77650_getBOK()==target_val)
-   return true;
-  else
-   return false;  
+  return MAX77650_PMIC.setField(MAX77650_FIELD_BOK, target_val);
 }
 boolean MAX77650_setSBIA_LPM(boolean target_val){ //Returns Main Bias Low-Power Mode software request
-  MAX77650_write_register(MAX77650_CNFG_GLBL_ADDR,((MAX77650_read_register(MAX77650_CNFG_GLBL_ADDR) & 0b11011111) | ((target_val & 0b00000001) << 5)));
-  if(MAX77650_getSBIA_LPM()==target_val)
-   return true;
-  else
-   return false;  
+  return MAX77650_PMIC.setField(MAX77650_FIELD_SBIA_LPM, target_val);
 }
 boolean MAX77650_setSBIA_EN(boolean target_val){ //Returns Main Bias Enable Software Request
-  MAX77650_write_register(MAX77650_CNFG_GLBL_ADDR,((MAX77650_read_register(MAX77650_CNFG_GLBL_ADDR) & 0b11101111) | ((target_val & 0b00000001) << 4)));
-  if(MAX77650_getSBIA_EN()==target_val)
-   return true;
-  else
-   return false;  
+  return MAX77650_PMIC.setField(MAX77650_FIELD_SBIA_EN, target_val);
 }
 boolean MAX77650_setnEN_MODE(boolean target_val){ //Returns nEN Input (ONKEY) Default Configuration Mode
-  MAX77650_write_register(MAX77650_CNFG_GLBL_ADDR,((MAX77650_read_register(MAX77650_CNFG_GLBL_ADDR) & 0b11110111) | ((target_val & 0b00000001) << 3)));
-  if(MAX77650_getnEN_MODE()==target_val)
-   return true;
-  else
-   return false;  
+  return MAX77650_PMIC.setField(MAX77650_FIELD_nEN_MODE, target_val);
 }
 boolean MAX77650_setDBEN_nEN(boolean target_val){ //Returns Debounce Timer Enable for the nEN Pin
-  MAX77650_write_register(MAX77650_CNFG_GLBL_ADDR,((MAX77650_read_register(MAX77650_CNFG_GLBL_ADDR) & 0b11111011) | ((target_val & 0b00000001) << 2)));
-  if(MAX77650_getDBEN_nEN()==target_val)
-   return true;
-  else
-   return false;  
+  return MAX77650_PMIC.setField(MAX77650_FIELD_DBEN_nEN, target_val);
 }
 boolean MAX77650_setSFT_RST(byte target_val){ //Returns Software Reset Functions.
-  MAX77650_write_register(MAX77650_CNFG_GLBL_ADDR,((MAX77650_read_register(MAX77650_CNFG_GLBL_ADDR) & 0b11111100) | ((target_val & 0b00000011) << 0)));
-  if(MAX77650_getSFT_RST()==target_val)
-   return true;
-  else
-   return false;  
+  return MAX77650_PMIC.setField(MAX77650_FIELD_SFT_RST, target_val);
 }
 
 //Global Interrupt Mask Register 0x06
 boolean MAX77650_setINT_M_GLBL(byte target_val){ //Sets Global Interrupt Mask Register
-  MAX77650_write_register(MAX77650_INTM_GLBL_ADDR,(target_val & 0b01111111));
-  if(MAX77650_getINT_M_GLBL()==(target_val & 0b01111111))
-   return true;
-  else
-   return false;   
+  return MAX77650_PMIC.setField(MAX77650_FIELD_INT_M_GLBL, target_val & 0b01111111);
 }
 
 //GPIO Configuration Register
 boolean MAX77650_setDBEN_GPI(boolean target_val){ //Returns General Purpose Input Debounce Timer Enable
-  MAX77650_write_register(MAX77650_CNFG_GPIO_ADDR,((MAX77650_read_register(MAX77650_CNFG_GPIO_ADDR) & 0b11101111) | ((target_val & 0b00000001) << 4)));
-  if(MAX77650_getDBEN_GPI()==target_val)
-   return true;
-  else
-   return false;
+  return MAX77650_PMIC.setField(MAX77650_FIELD_DBEN_GPI, target_val);
 }
 boolean MAX77650_setDO(boolean target_val){ //Returns General Purpose Output Data Output
-  MAX77650_write_register(MAX77650_CNFG_GPIO_ADDR,((MAX77650_read_register(MAX77650_CNFG_GPIO_ADDR) & 0b11110111) | ((target_val & 0b00000001) << 3)));
-  if(MAX77650_getDO()==target_val)
-   return true;
-  else
-   return false;
+  return MAX77650_PMIC.setField(MAX77650_FIELD_DO, target_val);
 }
 boolean MAX77650_setDRV(boolean target_val){ //Returns General Purpose Output Driver Type
-  MAX77650_write_register(MAX77650_CNFG_GPIO_ADDR,((MAX77650_read_register(MAX77650_CNFG_GPIO_ADDR) & 0b11111011) | ((target_val & 0b00000001) << 2)));
-  if(MAX77650_getDRV()==target_val)
-   return true;
-  else
-   return false;
+  return MAX77650_PMIC.setField(MAX77650_FIELD_DRV, target_val);
 }
 boolean MAX77650_setDI(boolean target_val){ //Returns GPIO Digital Input Value
-  MAX77650_write_register(MAX77650_CNFG_GPIO_ADDR,((MAX77650_read_register(MAX77650_CNFG_GPIO_ADDR) & 0b11111101) | ((target_val & 0b00000001) << 1)));
-  if(MAX77650_getDI()==target_val)
-   return true;
-  else
-   return false;
+  return MAX77650_PMIC.setField(MAX77650_FIELD_DI, target_val);
 }
 boolean MAX77650_setDIR(boolean target_val){ //Returns GPIO Direction
-  MAX77650_write_register(MAX77650_CNFG_GPIO_ADDR,((MAX77650_read_register(MAX77650_CNFG_GPIO_ADDR) & 0b11111110) | ((target_val & 0b00000001) << 0)));
-  if(MAX77650_getDIR()==target_val)
-   return true;
-  else
-   return false;
+  return MAX77650_PMIC.setField(MAX77650_FIELD_DIR, target_val);
 }
 
 //Charger Interrupt Mask Register 0x07
 boolean MAX77650_setINT_M_CHG(byte target_val){ //Sets Global Interrupt Mask Register
-  MAX77650_write_register(MAX77650_INT_M_CHG_ADDR,(target_val & 0b01111111));
-  if(MAX77650_getINT_M_CHG()==(target_val & 0b01111111))
-   return true;
+  return MAX77650_PMIC.setField(MAX77650_FIELD_INT_M_CHG, target_val & 0b01111111);
+}
+
+//***** Charger profiles *****
+
+byte MAX77650_out_of_range(byte clamped){ //not constexpr by intention, see header
+  return clamped;
+}
+
+boolean MAX77650::applyChargerProfile(const MAX77650_charger_profile &profile){
+  MAX77650_guard guard(_lock, 1 << MAX77650_GROUP_CHARGER);
+  byte readback[MAX77650_CHG_PROFILE_LEN];
+  if (!writeBurst(MAX77650_CNFG_CHG_A_ADDR, profile.reg, MAX77650_CHG_PROFILE_LEN))
+   return false;
+  if (!readBurst(MAX77650_CNFG_CHG_A_ADDR, readback, MAX77650_CHG_PROFILE_LEN))
+   return false;
+  for (byte i = 0; i < MAX77650_CHG_PROFILE_LEN; i++)
+   if ((readback[i] ^ profile.reg[i]) & MAX77650_chg_profile_mask[i])
+    return false;
+  return true;
+}
+
+boolean MAX77650::getChargerProfile(MAX77650_charger_profile &profile){
+  return readBurst(MAX77650_CNFG_CHG_A_ADDR, profile.reg, MAX77650_CHG_PROFILE_LEN);
+}
+
+boolean MAX77650_applyChargerProfile(const MAX77650_charger_profile &profile){ //Writes CNFG_CHG_A..I in one burst and verifies them with one burst read
+  return MAX77650_PMIC.applyChargerProfile(profile);
+}
+
+boolean MAX77650_getChargerProfile(MAX77650_charger_profile &profile){ //Reads CNFG_CHG_A..I in one burst into the profile
+  return MAX77650_PMIC.getChargerProfile(profile);
+}
+
+
+//***** Interrupt service *****
+
+static volatile boolean MAX77650_irq_pending = false;
+static volatile unsigned long MAX77650_irq_time;   //millis() of the first IRQ since the last service
+
+static void MAX77650_chargeController_service(const MAX77650_irq_snapshot&);
+static void MAX77650_jeita_service(const MAX77650_irq_snapshot&);
+static void MAX77650_button_service(const MAX77650_irq_snapshot&);
+static void MAX77650_gpio_service(const MAX77650_irq_snapshot&);
+static void MAX77650_telemetry_service(const MAX77650_irq_snapshot&);
+static void MAX77650_faultlog_service(const MAX77650_irq_snapshot&);
+static void MAX77650_throttle_service(const MAX77650_irq_snapshot&);
+
+void MAX77650_IRQ(void){ //Interrupt service routine for the IRQ pin of the MAX77650
+  if (!MAX77650_irq_pending)
+   MAX77650_irq_time = millis();
+  MAX77650_irq_pending = true;
+}
+
+boolean MAX77650_interruptPending(void){ //Returns whether the IRQ pin fired since the last MAX77650_serviceInterrupts
+  return MAX77650_irq_pending;
+}
+
+boolean MAX77650_serviceInterrupts(MAX77650_irq_snapshot *snapshot){ //Reads and clears the interrupt registers and runs the library modules
+  MAX77650_latency_probe probe(MAX77650_LAT_IRQ);
+  byte regs[4];
+  MAX77650_irq_snapshot irq;
+  irq.time = MAX77650_irq_pending ? MAX77650_irq_time : millis();
+  MAX77650_irq_pending = false;   //cleared before reading, an edge during the read is not lost
+  if (!MAX77650_read_burst(MAX77650_INT_GLBL_ADDR, regs, 4))
+   return false;
+  irq.INT_GLBL = regs[0];
+  irq.INT_CHG = regs[1];
+  irq.STAT_CHG_A = regs[2];
+  irq.STAT_CHG_B = regs[3];
+  MAX77650_LOG(MAX77650_LOG_DEBUG, MAX77650_MSG_IRQ, irq.INT_GLBL, irq.INT_CHG);
+  MAX77650_chargeController_service(irq);
+  MAX77650_jeita_service(irq);
+  MAX77650_button_service(irq);
+  MAX77650_gpio_service(irq);
+  MAX77650_telemetry_service(irq);
+  MAX77650_faultlog_service(irq);
+  MAX77650_throttle_service(irq);
+  if (snapshot)
+   *snapshot = irq;
+  return true;
+}
+
+
+//***** Adaptive charge-current controller *****
+
+#define MAX77650_STAT_CHG_A_VCHGIN_MIN 0b01000000
+#define MAX77650_STAT_CHG_A_ICHGIN_LIM 0b00100000
+#define MAX77650_STAT_CHG_A_TJ_REG 0b00001000
+#define MAX77650_CHGCTRL_HOLDOFF_MAX 16    //maximum multiplier of the hold-off time
+
+static struct {
+  boolean enabled;
+  byte cc;                    //CHG_CC code set by the controller
+  byte cc_max;                //ceiling of CHG_CC in effect: the lowest of the ones below
+  byte cc_ceiling;            //ceiling of CHG_CC set by begin or setCeiling
+  byte cc_profile;            //CHG_CC of the charger profile applied last
+  byte cc_throttle;           //ceiling of CHG_CC of the thermal throttling
+  boolean throttled;          //cc_throttle is in effect
+  byte lim;                   //ICHGIN_LIM code set by the controller
+  byte lim_max;               //ceiling of ICHGIN_LIM
+  byte stat;                  //last seen regulation loops of STAT_CHG_A
+  byte holdoff_mult;          //current multiplier of the hold-off time
+  unsigned long holdoff_ms;   //base hold-off time
+  unsigned long last_step;    //millis() of the last change
+  unsigned long polled;       //millis() of the last read of STAT_CHG_A while a loop was engaged
+  boolean last_was_raise;     //last change was a raise
+} MAX77650_chgctrl;
+
+static void MAX77650_chargeController_backoff(void){ //a loop engaged: a raise within the hold-off was too much
+  if (MAX77650_chgctrl.last_was_raise && (millis() - MAX77650_chgctrl.last_step) < MAX77650_chgctrl.holdoff_ms * MAX77650_chgctrl.holdoff_mult)
+   if (MAX77650_chgctrl.holdoff_mult < MAX77650_CHGCTRL_HOLDOFF_MAX)
+    MAX77650_chgctrl.holdoff_mult <<= 1;
+  MAX77650_chgctrl.last_was_raise = false;
+  MAX77650_chgctrl.last_step = millis();
+}
+
+static void MAX77650_chargeController_step(void){ //one step against the engaged loops of stat
+  if ((MAX77650_chgctrl.stat & MAX77650_STAT_CHG_A_TJ_REG) && MAX77650_chgctrl.cc > 0){
+    byte step = MAX77650_chgctrl.cc >> 3;
+    MAX77650_chgctrl.cc -= step ? step : 1;
+    MAX77650_setCHG_CC(MAX77650_chgctrl.cc);
+    MAX77650_chargeController_backoff();
+  }
+  if (MAX77650_chgctrl.stat & MAX77650_STAT_CHG_A_VCHGIN_MIN){
+    if (MAX77650_chgctrl.lim > 0){
+      MAX77650_setICHGIN_LIM(--MAX77650_chgctrl.lim);
+      MAX77650_chargeController_backoff();
+    }
+  }
+  else if ((MAX77650_chgctrl.stat & MAX77650_STAT_CHG_A_ICHGIN_LIM) && MAX77650_chgctrl.lim < MAX77650_chgctrl.lim_max){
+    MAX77650_setICHGIN_LIM(++MAX77650_chgctrl.lim);
+    MAX77650_chgctrl.last_was_raise = true;
+    MAX77650_chgctrl.last_step = millis();
+  }
+}
+
+static void MAX77650_chargeController_service(const MAX77650_irq_snapshot &irq){
+  if (!MAX77650_chgctrl.enabled)
+   return;
+  if (!(irq.INT_CHG & (MAX77650_INT_CHG_TJ_REG_I | MAX77650_INT_CHG_CHGIN_CTRL_I)))
+   return;
+  MAX77650_chgctrl.stat = irq.STAT_CHG_A & (MAX77650_STAT_CHG_A_VCHGIN_MIN | MAX77650_STAT_CHG_A_ICHGIN_LIM | MAX77650_STAT_CHG_A_TJ_REG);
+  MAX77650_chargeController_step();
+}
+
+static void MAX77650_chargeController_limit(void){ //takes the lowest ceiling and lowers CHG_CC to it
+  MAX77650_chgctrl.cc_max = (MAX77650_chgctrl.cc_ceiling < MAX77650_chgctrl.cc_profile) ? MAX77650_chgctrl.cc_ceiling : MAX77650_chgctrl.cc_profile;
+  if (MAX77650_chgctrl.throttled && MAX77650_chgctrl.cc_throttle < MAX77650_chgctrl.cc_max)
+   MAX77650_chgctrl.cc_max = MAX77650_chgctrl.cc_throttle;
+  if (MAX77650_chgctrl.enabled && MAX77650_chgctrl.cc > MAX77650_chgctrl.cc_max)
+   MAX77650_setCHG_CC(MAX77650_chgctrl.cc = MAX77650_chgctrl.cc_max);
+}
+
+boolean MAX77650_chargeController_begin(byte cc_max, byte lim_max, unsigned long holdoff_ms){ //Starts the controller
+  MAX77650_chgctrl.enabled = false;
+  MAX77650_chgctrl.cc_ceiling = (cc_max > 0x27) ? 0x27 : cc_max;     //0x27 reflects 300mA, codes above do not raise the current
+  MAX77650_chgctrl.cc_profile = 0x27;
+  MAX77650_chgctrl.lim_max = (lim_max > 0x04) ? 0x04 : lim_max;  //0x04 reflects 475mA
+  int cc = MAX77650_PMIC.getField(MAX77650_FIELD_CHG_CC);
+  int lim = MAX77650_PMIC.getField(MAX77650_FIELD_ICHGIN_LIM);
+  int stat = MAX77650_read_register(MAX77650_STAT_CHG_A_ADDR);
+  if (cc < 0 || lim < 0 || stat < 0)
+   return false;
+  MAX77650_chgctrl.cc = cc;
+  MAX77650_chgctrl.lim = lim;
+  MAX77650_chargeController_limit();   //the controller is stopped: sets cc_max only
+  if (MAX77650_chgctrl.cc > MAX77650_chgctrl.cc_max)
+   if (!MAX77650_setCHG_CC(MAX77650_chgctrl.cc = MAX77650_chgctrl.cc_max))
+    return false;
+  if (MAX77650_chgctrl.lim > MAX77650_chgctrl.lim_max)
+   if (!MAX77650_setICHGIN_LIM(MAX77650_chgctrl.lim = MAX77650_chgctrl.lim_max))
+    return false;
+  MAX77650_chgctrl.stat = stat & (MAX77650_STAT_CHG_A_VCHGIN_MIN | MAX77650_STAT_CHG_A_ICHGIN_LIM | MAX77650_STAT_CHG_A_TJ_REG);
+  MAX77650_chgctrl.holdoff_ms = holdoff_ms;
+  MAX77650_chgctrl.holdoff_mult = 1;
+  MAX77650_chgctrl.last_step = millis();
+  MAX77650_chgctrl.polled = MAX77650_chgctrl.last_step;
+  MAX77650_chgctrl.last_was_raise = false;
+  //only the two interrupts are unmasked, the mask bits of the others are left as they are
+  if (!MAX77650_PMIC.updateRegister(MAX77650_INT_M_CHG_ADDR, MAX77650_INT_CHG_TJ_REG_I | MAX77650_INT_CHG_CHGIN_CTRL_I, 0))
+   return false;
+  MAX77650_chgctrl.enabled = true;
+  return true;
+}
+
+void MAX77650_chargeController_end(void){ //Stops the controller; the last settings stay active
+  MAX77650_chgctrl.enabled = false;
+}
+
+static void MAX77650_chargeController_adopt(const MAX77650_charger_profile &profile){ //a profile has been applied: restart from its currents
+  byte cc = profile.reg[4] >> 2;
+  byte lim = (profile.reg[1] >> 2) & 0b111;
+  MAX77650_chgctrl.cc = MAX77650_chgctrl.cc_profile = (cc > 0x27) ? 0x27 : cc;
+  MAX77650_chargeController_limit();   //the ceiling of the application still holds
+  MAX77650_chgctrl.lim = (lim > MAX77650_chgctrl.lim_max) ? MAX77650_chgctrl.lim_max : lim;
+  if (MAX77650_chgctrl.enabled && MAX77650_chgctrl.lim != lim)
+   MAX77650_setICHGIN_LIM(MAX77650_chgctrl.lim);
+  MAX77650_chgctrl.holdoff_mult = 1;
+  MAX77650_chgctrl.last_was_raise = false;
+  MAX77650_chgctrl.last_step = millis();
+}
+
+static void MAX77650_chargeController_throttle(boolean throttled, byte cc){ //the thermal throttling limits CHG_CC to cc
+  MAX77650_chgctrl.throttled = throttled;
+  MAX77650_chgctrl.cc_throttle = cc;
+  MAX77650_chargeController_limit();
+}
+
+void MAX77650_chargeController_setCeiling(byte cc_max){ //Sets the CHG_CC ceiling (register code)
+  MAX77650_chgctrl.cc_ceiling = (cc_max > 0x27) ? 0x27 : cc_max;
+  MAX77650_chargeController_limit();
+}
+
+void MAX77650_chargeController_tick(void){ //Raises the currents once the hold-off has expired
+  if (!MAX77650_chgctrl.enabled)
+   return;
+  unsigned long holdoff = MAX77650_chgctrl.holdoff_ms * MAX77650_chgctrl.holdoff_mult;
+  if ((millis() - MAX77650_chgctrl.last_step) < holdoff)
+   return;
+  if (MAX77650_chgctrl.stat){   //the interrupts only report changes: follow a loop which stays engaged by reading its status
+    if ((millis() - MAX77650_chgctrl.polled) < holdoff)
+     return;
+    MAX77650_chgctrl.polled = millis();
+    int stat = MAX77650_read_register(MAX77650_STAT_CHG_A_ADDR);
+    if (stat < 0)
+     return;
+    MAX77650_chgctrl.stat = stat & (MAX77650_STAT_CHG_A_VCHGIN_MIN | MAX77650_STAT_CHG_A_ICHGIN_LIM | MAX77650_STAT_CHG_A_TJ_REG);
+    if (MAX77650_chgctrl.stat){
+      MAX77650_chargeController_step();
+      return;
+    }
+  }
+  if (MAX77650_chgctrl.last_was_raise && MAX77650_chgctrl.holdoff_mult > 1)  //the last raise was fine
+   MAX77650_chgctrl.holdoff_mult >>= 1;
+  if (MAX77650_chgctrl.cc < MAX77650_chgctrl.cc_max)
+   MAX77650_setCHG_CC(++MAX77650_chgctrl.cc);
+  else if (MAX77650_chgctrl.lim < MAX77650_chgctrl.lim_max)
+   MAX77650_setICHGIN_LIM(++MAX77650_chgctrl.lim);
   else
-   return false;   
+   return;    //both at their ceilings
+  MAX77650_chgctrl.last_was_raise = true;
+  MAX77650_chgctrl.last_step = millis();
+}
+
+byte MAX77650_chargeController_getCHG_CC(void){ //Returns the CHG_CC code the controller has set
+  return MAX77650_chgctrl.cc;
+}
+
+byte MAX77650_chargeController_getICHGIN_LIM(void){ //Returns the ICHGIN_LIM code the controller has set
+  return MAX77650_chgctrl.lim;
+}
+
+
+//***** Analog multiplexer *****
+
+static int (*MAX77650_amux_reader)(void) = NULL;
+static int MAX77650_amux_full_scale = 1024;
+static unsigned int MAX77650_amux_settle_ms = 5;
+
+void MAX77650_setAMUXReader(int (*reader)(void), int full_scale, unsigned int settle_ms){ //Sets the ADC reading function for the AMUX pin
+  MAX77650_amux_reader = reader;
+  MAX77650_amux_full_scale = full_scale;
+  MAX77650_amux_settle_ms = settle_ms;
+}
+
+boolean MAX77650_readAMUX(const byte *channels, int *counts, byte n){ //Measures the given channels in a row and switches the multiplexer off
+  boolean retval = true;
+  if (!MAX77650_amux_reader)
+   return false;
+  for (byte i = 0; i < n; i++){
+    MAX77650_latency_probe probe(MAX77650_LAT_AMUX);
+    if (!MAX77650_setMUX_SEL(channels[i])){
+      counts[i] = -1;
+      retval = false;
+      continue;
+    }
+    delay(MAX77650_amux_settle_ms);
+    counts[i] = MAX77650_amux_reader();
+  }
+  MAX77650_setMUX_SEL(MAX77650_MUX_OFF);
+  return retval;
+}
+
+int MAX77650_readAMUX(byte channel){ //Measures one channel
+  int counts = -1;
+  MAX77650_readAMUX(&channel, &counts, 1);
+  return counts;
+}
+
+int MAX77650_getThermistorTemp_dC(void){ //Returns the battery temperature in 0.1°C from the THM/TBIAS ratio
+  static const byte channels[2] = {MAX77650_MUX_THM_V, MAX77650_MUX_TBIAS_V};
+  int counts[2];
+  if (!MAX77650_readAMUX(channels, counts, 2) || counts[0] <= 0 || counts[1] <= counts[0])
+   return MAX77650_TEMP_INVALID;
+  //NTC against a pull-up of R25 to TBIAS: R/R25 = THM / (TBIAS - THM)
+  float kelvin = 1.0 / (1.0 / 298.15 + log((float)counts[0] / (counts[1] - counts[0])) / MAX77650_NTC_BETA);
+  return (int)((kelvin - 273.15) * 10.0 + ((kelvin > 273.15) ? 0.5 : -0.5));
+}
+
+
+//***** JEITA charging supervisor *****
+
+static struct {
+  boolean enabled;
+  const MAX77650_charger_profile *table[MAX77650_THM_ZONES];
+  byte zone;                    //zone whose profile is active
+  byte pending;                 //zone reported by THM_DTLS, waiting for the hysteresis
+  byte hysteresis_dC;
+  unsigned long interval_ms;    //sampling interval of pending moves
+  unsigned long last_sample;
+  int temp_dC;                  //last sampled thermistor temperature
+} MAX77650_jeita;
+
+static byte MAX77650_jeita_rank(byte zone){ //charge rate ranking of the zones; higher means lower charge rate
+  switch (zone){
+    case MAX77650_THM_COOL:
+    case MAX77650_THM_WARM:
+     return 1;
+    case MAX77650_THM_COLD:
+    case MAX77650_THM_HOT:
+     return 2;
+    default:
+     return 0;
+  }
+}
+
+static boolean MAX77650_jeita_inside(byte zone, int temp_dC){ //temperature is the hysteresis inside the zone
+  const MAX77650_charger_profile *profile = MAX77650_jeita.table[zone] ? MAX77650_jeita.table[zone] : MAX77650_jeita.table[MAX77650_THM_NORMAL];
+  byte thm = profile ? profile->reg[0] : 0x0F;   //JEITA thresholds (CNFG_CHG_A) of the zone
+  int lo = -32767, hi = 32767;
+  switch (zone){
+    case MAX77650_THM_COLD: hi = MAX77650_THM_COLD_to_C(thm) * 10; break;
+    case MAX77650_THM_COOL: lo = MAX77650_THM_COLD_to_C(thm) * 10; hi = MAX77650_THM_COOL_to_C(thm >> 2) * 10; break;
+    case MAX77650_THM_NORMAL: lo = MAX77650_THM_COOL_to_C(thm >> 2) * 10; hi = MAX77650_THM_WARM_to_C(thm >> 4) * 10; break;
+    case MAX77650_THM_WARM: lo = MAX77650_THM_WARM_to_C(thm >> 4) * 10; hi = MAX77650_THM_HOT_to_C(thm >> 6) * 10; break;
+    case MAX77650_THM_HOT: lo = MAX77650_THM_HOT_to_C(thm >> 6) * 10; break;
+    default: return true;
+  }
+  return (temp_dC >= lo + MAX77650_jeita.hysteresis_dC) && (temp_dC <= hi - MAX77650_jeita.hysteresis_dC);
+}
+
+static void MAX77650_jeita_apply(byte zone){
+  MAX77650_jeita.zone = zone;
+  MAX77650_jeita.pending = zone;
+  if (!MAX77650_jeita.table[zone])
+   return;
+  MAX77650_LOG(MAX77650_LOG_INFO, MAX77650_MSG_JEITA_ZONE, zone, MAX77650_jeita.temp_dC);
+  MAX77650_applyChargerProfile(*MAX77650_jeita.table[zone]);
+  MAX77650_chargeController_adopt(*MAX77650_jeita.table[zone]);
+}
+
+static void MAX77650_jeita_move(byte zone){ //THM_DTLS reported a zone
+  if (zone >= MAX77650_THM_ZONES || zone == MAX77650_jeita.zone){
+    MAX77650_jeita.pending = MAX77650_jeita.zone;
+    return;
+  }
+  if (MAX77650_jeita_rank(zone) >= MAX77650_jeita_rank(MAX77650_jeita.zone) || !MAX77650_amux_reader){
+    MAX77650_jeita_apply(zone);
+    return;
+  }
+  MAX77650_jeita.pending = zone;
+  MAX77650_jeita.last_sample = millis();
+  MAX77650_jeita.temp_dC = MAX77650_getThermistorTemp_dC();
+  if (MAX77650_jeita.temp_dC == MAX77650_TEMP_INVALID || MAX77650_jeita_inside(zone, MAX77650_jeita.temp_dC))
+   MAX77650_jeita_apply(zone);
+}
+
+static void MAX77650_jeita_service(const MAX77650_irq_snapshot &irq){
+  if (MAX77650_jeita.enabled && (irq.INT_CHG & MAX77650_INT_CHG_THM_I))
+   MAX77650_jeita_move(irq.STAT_CHG_A & 0b00000111);
+}
+
+boolean MAX77650_jeita_begin(const MAX77650_charger_profile * const *table, byte hysteresis_C, unsigned long interval_ms){ //Starts the supervisor
+  for (byte i = 0; i < MAX77650_THM_ZONES; i++)
+   MAX77650_jeita.table[i] = table[i];
+  MAX77650_jeita.hysteresis_dC = hysteresis_C * 10;
+  MAX77650_jeita.interval_ms = interval_ms;
+  MAX77650_jeita.temp_dC = MAX77650_getThermistorTemp_dC();
+  byte zone = MAX77650_getTHM_DTLS();
+  MAX77650_jeita_apply((zone < MAX77650_THM_ZONES) ? zone : MAX77650_THM_NORMAL);
+  MAX77650_jeita.enabled = true;
+  return MAX77650_setINT_M_CHG(MAX77650_getINT_M_CHG() & ~MAX77650_INT_CHG_THM_I);
+}
+
+void MAX77650_jeita_end(void){ //Stops the supervisor
+  MAX77650_jeita.enabled = false;
+}
+
+void MAX77650_jeita_tick(void){ //Samples the thermistor only while a move into a zone with a higher charge rate is pending
+  if (!MAX77650_jeita.enabled || MAX77650_jeita.pending == MAX77650_jeita.zone)
+   return;
+  if ((millis() - MAX77650_jeita.last_sample) < MAX77650_jeita.interval_ms)
+   return;
+  MAX77650_jeita.last_sample = millis();
+  MAX77650_jeita.temp_dC = MAX77650_getThermistorTemp_dC();
+  if (MAX77650_jeita.temp_dC == MAX77650_TEMP_INVALID || MAX77650_jeita_inside(MAX77650_jeita.pending, MAX77650_jeita.temp_dC))
+   MAX77650_jeita_apply(MAX77650_jeita.pending);
+}
+
+byte MAX77650_jeita_getZone(void){ //Returns the zone whose profile is active
+  return MAX77650_jeita.zone;
+}
+
+int MAX77650_jeita_getTemp_dC(void){ //Returns the last sampled thermistor temperature in 0.1°C
+  return MAX77650_jeita.temp_dC;
+}
+
+
+//***** Request scheduler *****
+
+struct MAX77650_request {
+  byte reg;                 //register address
+  byte mask;                //bits to write
+  byte value;
+  byte prio;                //priority class
+  unsigned long deadline;   //millis() by which the request should be written; 0=none
+};
+
+static struct {
+  MAX77650_request queue[MAX77650_SCHEDULER_LEN];
+  byte count;
+  MAX77650_scheduler_stats stats;
+} MAX77650_sched;
+
+static boolean MAX77650_sched_before(const MAX77650_request &a, const MAX77650_request &b, unsigned long now){ //a is written before b
+  boolean a_late = a.deadline && (long)(now - a.deadline) >= 0;
+  boolean b_late = b.deadline && (long)(now - b.deadline) >= 0;
+  if (a_late != b_late)
+   return a_late;
+  if (a.prio != b.prio && !a_late)
+   return a.prio < b.prio;
+  if (!a.deadline || !b.deadline)
+   return a.deadline != 0;
+  return (long)(a.deadline - b.deadline) < 0;
+}
+
+static boolean MAX77650_sched_merge(const MAX77650_request &req, boolean newer){ //merges a request into the queue; newer=its bits replace pending ones
+  for (byte i = 0; i < MAX77650_sched.count; i++){
+    MAX77650_request &q = MAX77650_sched.queue[i];
+    if (q.reg != req.reg)
+     continue;
+    byte bits = newer ? req.mask : (req.mask & ~q.mask);
+    q.value = (q.value & ~bits) | (req.value & bits);
+    q.mask |= req.mask;
+    if (req.prio < q.prio)
+     q.prio = req.prio;
+    if (req.deadline && (!q.deadline || (long)(req.deadline - q.deadline) < 0))
+     q.deadline = req.deadline;
+    if (newer)
+     MAX77650_sched.stats.coalesced++;
+    return true;
+  }
+  if (MAX77650_sched.count >= MAX77650_SCHEDULER_LEN){
+    MAX77650_sched.stats.rejected++;
+    return false;
+  }
+  MAX77650_sched.queue[MAX77650_sched.count++] = req;
+  return true;
+}
+
+boolean MAX77650_postRegister(byte ADDR, byte mask, byte value, byte prio, unsigned int deadline_ms){ //Posts a write of the bits (mask) of a register
+  MAX77650_request req = {ADDR, mask, value, prio, deadline_ms ? (millis() + deadline_ms) | 1 : 0};   //|1: 0 means no deadline
+  if (prio == MAX77650_PRIO_CRITICAL){
+    //the group stays locked from stripping the queue through the write: a tick writing the register finishes first, 
+    //and one failing afterwards cannot merge the older bits back
+    MAX77650_guard hold(MAX77650_PMIC.getLock(), 1 << MAX77650_register_group(ADDR));
+    {
+      MAX77650_guard guard(MAX77650_PMIC.getLock(), 1 << MAX77650_GROUP_BUS);
+      for (byte i = 0; i < MAX77650_sched.count; i++)
+       if (MAX77650_sched.queue[i].reg == ADDR && !(MAX77650_sched.queue[i].mask &= ~mask))
+        MAX77650_sched.queue[i--] = MAX77650_sched.queue[--MAX77650_sched.count];   //nothing left to write
+      MAX77650_sched.stats.posted++;
+    }
+    return MAX77650_PMIC.updateRegister(ADDR, mask, value);
+  }
+  MAX77650_guard guard(MAX77650_PMIC.getLock(), 1 << MAX77650_GROUP_BUS);
+  MAX77650_sched.stats.posted++;
+  return MAX77650_sched_merge(req, true);
+}
+
+boolean MAX77650_post(const MAX77650_field &field, byte value, byte prio, unsigned int deadline_ms){ //Posts a field write
+  return MAX77650_postRegister(field.reg, field.mask << field.shift, value << field.shift, prio, deadline_ms);
+}
+
+int MAX77650_scheduler_tick(byte n){ //Writes up to n requests
+  int written = 0;
+  while (n--){
+    MAX77650_request req;
+    unsigned long now = millis();
+    byte group;
+    {
+      MAX77650_guard guard(MAX77650_PMIC.getLock(), 1 << MAX77650_GROUP_BUS);
+      if (!MAX77650_sched.count)
+       break;
+      byte best = 0;
+      for (byte i = 1; i < MAX77650_sched.count; i++)
+       if (MAX77650_sched_before(MAX77650_sched.queue[i], MAX77650_sched.queue[best], now))
+        best = i;
+      group = MAX77650_register_group(MAX77650_sched.queue[best].reg);
+    }
+    //the group of the register stays locked from dequeuing through the write: a critical post of the register waits 
+    //for it instead of being overwritten by the older value
+    MAX77650_guard hold(MAX77650_PMIC.getLock(), 1 << group);
+    {
+      MAX77650_guard guard(MAX77650_PMIC.getLock(), 1 << MAX77650_GROUP_BUS);
+      int best = -1;   //the queue may have changed meanwhile: the most urgent request of the group
+      for (byte i = 0; i < MAX77650_sched.count; i++)
+       if (MAX77650_register_group(MAX77650_sched.queue[i].reg) == group && (best < 0 || MAX77650_sched_before(MAX77650_sched.queue[i], MAX77650_sched.queue[best], now)))
+        best = i;
+      if (best < 0)
+       continue;   //taken by a critical post
+      req = MAX77650_sched.queue[best];
+      MAX77650_sched.queue[best] = MAX77650_sched.queue[--MAX77650_sched.count];
+    }
+    //written outside of the queue lock: posts of other tasks do not wait for the transfer
+    if (!MAX77650_PMIC.updateRegister(req.reg, req.mask, req.value)){
+      MAX77650_guard guard(MAX77650_PMIC.getLock(), 1 << MAX77650_GROUP_BUS);
+      MAX77650_sched.stats.errors++;
+      MAX77650_sched_merge(req, false);   //requests posted meanwhile are newer
+      return -1;
+    }
+    MAX77650_sched.stats.executed++;
+    if (req.deadline && (long)(millis() - req.deadline) > 0)
+     MAX77650_sched.stats.late++;
+    written++;
+  }
+  return written;
+}
+
+boolean MAX77650_scheduler_flush(void){ //Writes all pending requests
+  while (MAX77650_sched.count)
+   if (MAX77650_scheduler_tick(MAX77650_sched.count) < 0)
+    return false;
+  return true;
+}
+
+byte MAX77650_scheduler_pending(void){ //Returns the number of pending requests
+  return MAX77650_sched.count;
+}
+
+const MAX77650_scheduler_stats& MAX77650_scheduler_getStats(void){ //Returns the counters of the scheduler
+  return MAX77650_sched.stats;
+}
+
+
+//***** Shutdown sequencer *****
+
+static struct {
+  int pin;                                    //host pin driving PWR_HLD; -1=none
+  unsigned int gap_ms;                        //time between the stages
+  byte stages[MAX77650_SHUTDOWN_STAGES];      //rails per stage
+  byte n;
+  unsigned long worst_us;
+} MAX77650_off = {-1, 0, {MAX77650_RAIL_ALL}, 1, 0};
+
+void MAX77650_shutdown_begin(int pin, unsigned int gap_ms){ //Sets the host pin driving PWR_HLD and holds the power
+  MAX77650_off.pin = pin;
+  MAX77650_off.gap_ms = gap_ms;
+#ifdef ARDUINO
+  if (pin >= 0){
+    pinMode(pin, OUTPUT);
+    digitalWrite(pin, HIGH);
+  }
+#endif
+}
+
+boolean MAX77650_shutdown_setSequence(const byte *stages, byte n){ //Sets the rails switched off per stage
+  if (!n || n > MAX77650_SHUTDOWN_STAGES)
+   return false;
+  memcpy(MAX77650_off.stages, stages, n);
+  MAX77650_off.n = n;
+  return true;
+}
+
+static int MAX77650_shutdown_value(byte ADDR){ //value of a register from the shadow, read if not cached
+  int value = MAX77650_PMIC.getShadow(ADDR);
+  return (value < 0) ? MAX77650_PMIC.readRegister(ADDR) : value;
+}
+
+static boolean MAX77650_shutdown_stage(byte rails, boolean dry_run){ //switches the rails of a stage off; a dry run writes the values unchanged
+  int value;
+  if (rails & MAX77650_RAIL_LEDS){
+    if ((value = MAX77650_shutdown_value(MAX77650_CNFG_LED_TOP_ADDR)) < 0)
+     return false;
+    if (MAX77650_PMIC.writeRegister(MAX77650_CNFG_LED_TOP_ADDR, dry_run ? value : value & ~0b00000001))
+     return false;
+  }
+  if (rails & MAX77650_RAIL_LDO){
+    if ((value = MAX77650_shutdown_value(MAX77650_CNFG_LDO_B_ADDR)) < 0)
+     return false;
+    if (MAX77650_PMIC.writeRegister(MAX77650_CNFG_LDO_B_ADDR, dry_run ? value : (value & ~0b00000111) | 0b100))
+     return false;
+  }
+  //CNFG_SBB0_B, CNFG_SBB1_B and CNFG_SBB2_B are 0x2A, 0x2C and 0x2E: one burst over the registers in between
+  byte first = 0xFF, last = 0;
+  for (byte ch = 0; ch < 3; ch++)
+   if (rails & (MAX77650_RAIL_SBB0 << ch)){
+     if (first == 0xFF)
+      first = MAX77650_CNFG_SBB0_B_ADDR + 2 * ch;
+     last = MAX77650_CNFG_SBB0_B_ADDR + 2 * ch;
+   }
+  if (first == 0xFF)
+   return true;
+  byte image[5];
+  for (byte ADDR = first; ADDR <= last; ADDR++){
+    if ((value = MAX77650_shutdown_value(ADDR)) < 0)
+     return false;
+    image[ADDR - first] = value;
+    byte ch = (ADDR - MAX77650_CNFG_SBB0_B_ADDR) / 2;
+    if (!dry_run && !((ADDR - MAX77650_CNFG_SBB0_B_ADDR) & 1) && (rails & (MAX77650_RAIL_SBB0 << ch)))
+     image[ADDR - first] = (value & ~0b00000111) | 0b100;
+  }
+  return MAX77650_PMIC.writeBurst(first, image, last - first + 1);
+}
+
+unsigned long MAX77650_shutdown(boolean software_off, boolean dry_run){ //Runs the sequence and powers off
+  unsigned long start = micros();
+  boolean flushed = MAX77650_scheduler_flush();
+  boolean ok = true;
+  {
+    MAX77650_guard guard(MAX77650_PMIC.getLock(), MAX77650_ALL_GROUPS);   //no task changes a rail meanwhile
+    if (!flushed){
+      //the rails go off anyway: the requests left are dropped instead of being written after the sequence
+      MAX77650_LOG(MAX77650_LOG_ERROR, MAX77650_MSG_SHUTDOWN_DROPPED, MAX77650_sched.count, MAX77650_PMIC.getLastError());
+      MAX77650_sched.count = 0;
+    }
+    for (byte i = 0; i < MAX77650_off.n && ok; i++){
+      if (i && MAX77650_off.gap_ms)
+       delay(MAX77650_off.gap_ms);
+      ok = MAX77650_shutdown_stage(MAX77650_off.stages[i], dry_run);
+    }
+    if (ok && !dry_run){
+#ifdef ARDUINO
+      if (MAX77650_off.pin >= 0)
+       digitalWrite(MAX77650_off.pin, LOW);
+#endif
+      if (software_off)
+       ok = MAX77650_PMIC.updateRegister(MAX77650_CNFG_GLBL_ADDR, 0b00000011, 0b10);   //SFT_RST: software off
+    }
+  }
+  unsigned long elapsed = micros() - start;
+  if (elapsed > MAX77650_off.worst_us)
+   MAX77650_off.worst_us = elapsed;
+  if (!ok)
+   MAX77650_LOG(MAX77650_LOG_ERROR, MAX77650_MSG_SHUTDOWN_FAILED, dry_run, elapsed);
+  return (ok && flushed) ? (elapsed ? elapsed : 1) : 0;
+}
+
+unsigned long MAX77650_shutdown_getWorst_us(void){ //Returns the longest duration of a sequence
+  return MAX77650_off.worst_us;
+}
+
+
+//***** nEN button gestures *****
+
+#define MAX77650_BTN_IDLE 0           //released
+#define MAX77650_BTN_DOWN 1           //first press
+#define MAX77650_BTN_WAIT_SECOND 2    //short press released, a second one would make a double press
+#define MAX77650_BTN_SECOND_DOWN 3    //second press of a double press
+#define MAX77650_BTN_HELD 4           //hold reported, waiting for the release
+
+static struct {
+  boolean enabled;
+  byte state;
+  byte gesture;                             //last gesture not yet fetched
+  unsigned int long_ms;
+  unsigned int double_ms;
+  unsigned int hold_ms;
+  unsigned long down;                       //millis() of the press
+  unsigned long up;                         //millis() of the release
+  void (*report)(byte, unsigned long);
+} MAX77650_button;
+
+static void MAX77650_button_report(byte gesture, unsigned long duration){
+  MAX77650_button.gesture = gesture;
+  MAX77650_button.state = (gesture == MAX77650_BTN_HOLD) ? MAX77650_BTN_HELD : MAX77650_BTN_IDLE;
+  if (MAX77650_button.report)
+   MAX77650_button.report(gesture, duration);
+}
+
+static void MAX77650_button_press(unsigned long t){
+  if (MAX77650_button.state == MAX77650_BTN_WAIT_SECOND){
+    if (t - MAX77650_button.up <= MAX77650_button.double_ms){
+      MAX77650_button.state = MAX77650_BTN_SECOND_DOWN;
+      return;
+    }
+    MAX77650_button_report(MAX77650_BTN_SHORT, MAX77650_button.up - MAX77650_button.down);   //window missed by tick
+  }
+  MAX77650_button.down = t;
+  MAX77650_button.state = MAX77650_BTN_DOWN;
+}
+
+static void MAX77650_button_release(unsigned long t){
+  unsigned long duration = t - MAX77650_button.down;
+  switch (MAX77650_button.state){
+    case MAX77650_BTN_DOWN:
+      if (duration >= MAX77650_button.hold_ms)
+       MAX77650_button_report(MAX77650_BTN_HOLD, duration);   //hold missed by tick
+      else if (duration >= MAX77650_button.long_ms)
+       MAX77650_button_report(MAX77650_BTN_LONG, duration);
+      else if (MAX77650_button.double_ms){
+        MAX77650_button.up = t;
+        MAX77650_button.state = MAX77650_BTN_WAIT_SECOND;
+        return;
+      }
+      else
+       MAX77650_button_report(MAX77650_BTN_SHORT, duration);
+      break;
+    case MAX77650_BTN_SECOND_DOWN:
+      MAX77650_button_report(MAX77650_BTN_DOUBLE, duration);
+      break;
+  }
+  MAX77650_button.state = MAX77650_BTN_IDLE;
+}
+
+static void MAX77650_button_service(const MAX77650_irq_snapshot &irq){
+  if (!MAX77650_button.enabled)
+   return;
+  boolean fell = irq.INT_GLBL & MAX77650_INT_GLBL_nEN_F;
+  boolean rose = irq.INT_GLBL & MAX77650_INT_GLBL_nEN_R;
+  boolean down = MAX77650_button.state == MAX77650_BTN_DOWN || MAX77650_button.state == MAX77650_BTN_SECOND_DOWN || MAX77650_button.state == MAX77650_BTN_HELD;
+  if (fell && rose && down){    //released and pressed again since the last service
+    MAX77650_button_release(irq.time);
+    MAX77650_button_press(irq.time);
+  }
+  else {
+    if (fell)
+     MAX77650_button_press(irq.time);
+    if (rose)
+     MAX77650_button_release(irq.time);
+  }
+}
+
+boolean MAX77650_button_begin(void (*report)(byte, unsigned long), unsigned int long_ms, unsigned int double_ms, unsigned int hold_ms){ //Starts the engine
+  MAX77650_button.report = report;
+  MAX77650_button.long_ms = long_ms;
+  MAX77650_button.double_ms = double_ms;
+  MAX77650_button.hold_ms = hold_ms;
+  MAX77650_button.gesture = MAX77650_BTN_NONE;
+  MAX77650_button.down = millis();
+  MAX77650_button.state = MAX77650_getDebounceStatusnEN0() ? MAX77650_BTN_HELD : MAX77650_BTN_IDLE;   //a press before the start is no gesture
+  MAX77650_button.enabled = true;
+  return MAX77650_setINT_M_GLBL(MAX77650_getINT_M_GLBL() & ~(MAX77650_INT_GLBL_nEN_F | MAX77650_INT_GLBL_nEN_R));
+}
+
+void MAX77650_button_end(void){ //Stops the engine
+  MAX77650_button.enabled = false;
+}
+
+void MAX77650_button_tick(void){ //Reports pending short presses and holds
+  if (!MAX77650_button.enabled)
+   return;
+  unsigned long now = millis();
+  if (MAX77650_button.state == MAX77650_BTN_WAIT_SECOND && now - MAX77650_button.up > MAX77650_button.double_ms)
+   MAX77650_button_report(MAX77650_BTN_SHORT, MAX77650_button.up - MAX77650_button.down);
+  else if (MAX77650_button.state == MAX77650_BTN_DOWN && now - MAX77650_button.down >= MAX77650_button.hold_ms)
+   MAX77650_button_report(MAX77650_BTN_HOLD, now - MAX77650_button.down);
+}
+
+byte MAX77650_button_getGesture(void){ //Returns and clears the last gesture
+  byte gesture = MAX77650_button.gesture;
+  MAX77650_button.gesture = MAX77650_BTN_NONE;
+  return gesture;
 }
 
 
+//***** GPIO *****
+
+#define MAX77650_GPIO_DO 0b00001000   //DO bit of CNFG_GPIO
+
+static struct {
+  byte edges;                             //unmasked edges
+  volatile byte seen;                     //edges since the last MAX77650_gpio_getEdges
+  void (*report)(byte, unsigned long);
+} MAX77650_gpio;
+
+static void MAX77650_gpio_service(const MAX77650_irq_snapshot &irq){
+  byte edges = irq.INT_GLBL & MAX77650_gpio.edges;
+  if (!edges)
+   return;
+  MAX77650_gpio.seen |= edges;
+  if (MAX77650_gpio.report)
+   MAX77650_gpio.report(edges, irq.time);
+}
+
+boolean MAX77650_gpio_mode(byte mode){ //Configures the GPIO in one write
+  return MAX77650_PMIC.updateRegister(MAX77650_CNFG_GPIO_ADDR, 0b00011101, mode);
+}
+
+boolean MAX77650_gpio_write(boolean level){ //Sets the output level
+  return MAX77650_PMIC.updateRegister(MAX77650_CNFG_GPIO_ADDR, MAX77650_GPIO_DO, level ? MAX77650_GPIO_DO : 0);
+}
+
+boolean MAX77650_gpio_toggle(void){ //Inverts the output level
+  MAX77650_guard guard(MAX77650_PMIC.getLock(), 1 << MAX77650_GROUP_GLOBAL);   //no other task writes between reading and writing DO
+  int value = MAX77650_PMIC.getShadow(MAX77650_CNFG_GPIO_ADDR);
+  if (value < 0 && (value = MAX77650_PMIC.readRegister(MAX77650_CNFG_GPIO_ADDR)) < 0)
+   return false;
+  return MAX77650_PMIC.updateRegister(MAX77650_CNFG_GPIO_ADDR, MAX77650_GPIO_DO, ~value);
+}
+
+int MAX77650_gpio_read(void){ //Returns the input level
+  int value = MAX77650_read_register(MAX77650_CNFG_GPIO_ADDR);
+  return (value < 0) ? -1 : (value >> 1) & 0b00000001;
+}
+
+boolean MAX77650_gpio_onEdge(byte edges, void (*report)(byte, unsigned long)){ //Unmasks the edges and sets the callback
+  const byte both = MAX77650_GPIO_FALLING | MAX77650_GPIO_RISING;
+  MAX77650_gpio.edges = edges & both;
+  MAX77650_gpio.report = report;
+  return MAX77650_PMIC.updateRegister(MAX77650_INTM_GLBL_ADDR, both, ~MAX77650_gpio.edges);
+}
 
+byte MAX77650_gpio_getEdges(void){ //Returns and clears the edges seen since the last call
+  byte edges = MAX77650_gpio.seen;
+  MAX77650_gpio.seen = 0;
+  return edges;
+}
+
+
+//***** Energy estimator *****
+
+#define MAX77650_ENERGY_UNITY 1024    //correction factor 1.0
+
+static struct {
+  unsigned int mV;              //output voltage
+  boolean enabled;
+  boolean active;               //load active
+  unsigned long active_uA;
+  unsigned long idle_uA;
+  byte efficiency;              //%
+  unsigned long power_uW;       //battery power now
+  unsigned long since;          //millis() of the last update
+  uint64_t energy;              //battery energy in µW*ms
+  unsigned long active_ms;      //time the load was active
+} MAX77650_rail[MAX77650_ENERGY_RAILS];
+
+static struct {
+  unsigned long capacity_uWh;
+  unsigned long start;          //millis() of MAX77650_energy_begin
+  unsigned long model_uW;       //sum of the rail powers
+  unsigned long measured_uW;
+  unsigned int correction;      //measured / model, MAX77650_ENERGY_UNITY=1.0
+} MAX77650_energy;
+
+static void MAX77650_energy_update(byte rail){ //integrates a rail up to now and recalculates its power
+  unsigned long now = millis();
+  unsigned long dt = now - MAX77650_rail[rail].since;
+  MAX77650_rail[rail].energy += (uint64_t)MAX77650_rail[rail].power_uW * dt;
+  if (MAX77650_rail[rail].active)
+   MAX77650_rail[rail].active_ms += dt;
+  MAX77650_rail[rail].since = now;
+  MAX77650_energy.model_uW -= MAX77650_rail[rail].power_uW;
+  unsigned long uA = MAX77650_rail[rail].active ? MAX77650_rail[rail].active_uA : MAX77650_rail[rail].idle_uA;
+  MAX77650_rail[rail].power_uW = MAX77650_rail[rail].enabled ? (unsigned long)((uint64_t)MAX77650_rail[rail].mV * uA / (10UL * MAX77650_rail[rail].efficiency)) : 0;
+  MAX77650_energy.model_uW += MAX77650_rail[rail].power_uW;
+}
+
+boolean MAX77650_energy_sync(void){ //Reads voltages and enables of the rails
+  byte sbb[6], ldo[2];
+  if (!MAX77650_read_burst(MAX77650_CNFG_SBB0_A_ADDR, sbb, 6) || !MAX77650_read_burst(MAX77650_CNFG_LDO_A_ADDR, ldo, 2))
+   return false;
+  const unsigned int mV[MAX77650_ENERGY_RAILS] = {MAX77650_PMIC.codeToVoltage(MAX77650_CNFG_SBB0_A_ADDR, sbb[0]), MAX77650_PMIC.codeToVoltage(MAX77650_CNFG_SBB1_A_ADDR, sbb[2]), 
+                                                  MAX77650_PMIC.codeToVoltage(MAX77650_CNFG_SBB2_A_ADDR, sbb[4]), MAX77650_PMIC.codeToVoltage(MAX77650_CNFG_LDO_A_ADDR, ldo[0])};
+  const byte en[MAX77650_ENERGY_RAILS] = {sbb[1], sbb[3], sbb[5], ldo[1]};
+  for (byte i = 0; i < MAX77650_ENERGY_RAILS; i++){
+    MAX77650_rail[i].mV = mV[i];
+    MAX77650_rail[i].enabled = (en[i] & 0b110) != 0b100;   //0b100/0b101: off; 0b110/0b111: on; 0b0xx: on with the sequencer
+    MAX77650_energy_update(i);
+  }
+  return true;
+}
+
+boolean MAX77650_energy_begin(unsigned long capacity_uWh){ //Starts the estimator
+  MAX77650_energy.capacity_uWh = capacity_uWh;
+  MAX77650_energy.start = millis();
+  MAX77650_energy.model_uW = 0;
+  MAX77650_energy.measured_uW = 0;
+  MAX77650_energy.correction = MAX77650_ENERGY_UNITY;
+  for (byte i = 0; i < MAX77650_ENERGY_RAILS; i++){
+    MAX77650_rail[i].power_uW = 0;
+    MAX77650_rail[i].energy = 0;
+    MAX77650_rail[i].active_ms = 0;
+    MAX77650_rail[i].since = MAX77650_energy.start;
+    if (!MAX77650_rail[i].efficiency)
+     MAX77650_rail[i].efficiency = 85;
+  }
+  return MAX77650_energy_sync();
+}
+
+void MAX77650_energy_setLoad(byte rail, unsigned long active_uA, unsigned long idle_uA, byte efficiency){ //Sets the load model of a rail
+  if (rail >= MAX77650_ENERGY_RAILS || !efficiency)
+   return;
+  MAX77650_rail[rail].active_uA = active_uA;
+  MAX77650_rail[rail].idle_uA = idle_uA;
+  MAX77650_rail[rail].efficiency = efficiency;
+  MAX77650_energy_update(rail);
+}
+
+void MAX77650_energy_setActive(byte rail, boolean active){ //Reports whether the load of a rail is active
+  if (rail >= MAX77650_ENERGY_RAILS || MAX77650_rail[rail].active == active)
+   return;
+  MAX77650_energy_update(rail);   //the time up to now counts for the previous state
+  MAX77650_rail[rail].active = active;
+  MAX77650_energy_update(rail);
+}
+
+boolean MAX77650_energy_measure(void){ //Measures the battery power with the AMUX and corrects the model
+  static const byte channels[3] = {MAX77650_MUX_BATT_V, MAX77650_MUX_BATT_DISCHG_I, MAX77650_MUX_BATT_DISCHG_I_NULL};
+  int counts[3];
+  int scale = MAX77650_getIMON_DISCHG_SCALE();
+  if (scale < 0 || !MAX77650_readAMUX(channels, counts, 3))
+   return false;
+  if (scale > 0x0A)
+   scale = 0x0A;
+  long fs = MAX77650_amux_full_scale;
+  unsigned long mV = (unsigned long)counts[0] * 4600 / fs;   //BATT_V: 4.6V at the AMUX full-scale
+  long net = counts[1] - counts[2];
+  unsigned long uA = (net > 0 && fs > counts[2]) ? (unsigned long)((uint64_t)net * MAX77650_IMON_DISCHG_SCALE_table[scale] * 100 / (fs - counts[2])) : 0;
+  MAX77650_energy.measured_uW = (unsigned long)((uint64_t)mV * uA / 1000);
+  if (MAX77650_energy.model_uW && MAX77650_energy.measured_uW){   //smoothed over 4 measurements; no discharge current while charging
+    uint64_t ratio = (uint64_t)MAX77650_energy.measured_uW * MAX77650_ENERGY_UNITY / MAX77650_energy.model_uW;
+    if (ratio > 8 * MAX77650_ENERGY_UNITY)
+     ratio = 8 * MAX77650_ENERGY_UNITY;
+    MAX77650_energy.correction = (3 * (unsigned long)MAX77650_energy.correction + (unsigned long)ratio) / 4;
+  }
+  return true;
+}
+
+void MAX77650_energy_getBudget(MAX77650_energy_budget &budget){ //Returns the power budget
+  unsigned long now = millis();
+  uint64_t total = 0;
+  for (byte i = 0; i < MAX77650_ENERGY_RAILS; i++){
+    unsigned long dt = now - MAX77650_rail[i].since;
+    uint64_t energy = MAX77650_rail[i].energy + (uint64_t)MAX77650_rail[i].power_uW * dt;
+    unsigned long active = MAX77650_rail[i].active_ms + (MAX77650_rail[i].active ? dt : 0);
+    budget.rail_uWh[i] = energy / 3600000UL;
+    budget.duty[i] = (now - MAX77650_energy.start) ? (uint64_t)active * 100 / (now - MAX77650_energy.start) : 0;
+    total += energy;
+  }
+  budget.model_uW = MAX77650_energy.model_uW;
+  budget.measured_uW = MAX77650_energy.measured_uW;
+  budget.power_uW = (uint64_t)MAX77650_energy.model_uW * MAX77650_energy.correction / MAX77650_ENERGY_UNITY;
+  budget.used_uWh = total * MAX77650_energy.correction / MAX77650_ENERGY_UNITY / 3600000UL;
+  budget.remaining_uWh = (budget.used_uWh < MAX77650_energy.capacity_uWh) ? MAX77650_energy.capacity_uWh - budget.used_uWh : 0;
+  budget.runtime_s = budget.power_uW ? (uint64_t)budget.remaining_uWh * 3600 / budget.power_uW : 0xFFFFFFFF;
+}
+
+
+//***** Telemetry *****
+
+#define MAX77650_TELEMETRY_SYNC 0b10100000      //header: sync pattern
+#define MAX77650_TELEMETRY_KEYFLAG 0b00001000   //header: key frame
+
+static struct {
+  byte channels[MAX77650_TELEMETRY_CHANNELS];
+  byte n;
+  byte sequence;
+  byte to_key;                                    //frames until the next key frame; 0=key frame next
+  byte stat[3];                                   //status registers of the previous frame
+  int amux[MAX77650_TELEMETRY_CHANNELS];          //AMUX readings of the previous frame
+  byte INT_GLBL, INT_CHG, irqs;                   //interrupts since the previous frame
+} MAX77650_tel;
+
+static byte MAX77650_crc8(const byte *data, byte len){ //CRC-8, polynomial 0x07, start 0x00
+  byte crc = 0;
+  while (len--){
+    crc ^= *data++;
+    for (byte i = 0; i < 8; i++)
+     crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : (crc << 1);
+  }
+  return crc;
+}
+
+static void MAX77650_telemetry_service(const MAX77650_irq_snapshot &irq){
+  MAX77650_tel.INT_GLBL |= irq.INT_GLBL;
+  MAX77650_tel.INT_CHG |= irq.INT_CHG;
+  if (MAX77650_tel.irqs < 255)
+   MAX77650_tel.irqs++;
+}
+
+boolean MAX77650_telemetry_begin(const byte *channels, byte n){ //Sets the AMUX channels sampled for every frame
+  if (n > MAX77650_TELEMETRY_CHANNELS)
+   return false;
+  memcpy(MAX77650_tel.channels, channels, n);
+  MAX77650_tel.n = n;
+  MAX77650_tel.to_key = 0;
+  return true;
+}
+
+boolean MAX77650_telemetry_frame(byte *frame){ //Samples the status and encodes a frame
+  byte stat[3];
+  int amux[MAX77650_TELEMETRY_CHANNELS] = {0};
+  if (!MAX77650_read_burst(MAX77650_STAT_CHG_A_ADDR, stat, 2))   //STAT_CHG_A and STAT_CHG_B
+   return false;
+  int glbl = MAX77650_read_register(MAX77650_STAT_GLBL_ADDR);   //read on its own: a burst from STAT_CHG_B would clear ERCFLAG in between
+  if (glbl < 0)
+   return false;
+  stat[2] = glbl;
+  if (MAX77650_tel.n && !MAX77650_readAMUX(MAX77650_tel.channels, amux, MAX77650_tel.n))
+   return false;
+  boolean key = !MAX77650_tel.to_key;
+  int value[MAX77650_TELEMETRY_CHANNELS];
+  for (byte i = 0; i < MAX77650_TELEMETRY_CHANNELS; i++){
+    if (amux[i] > 0x0FFF)   //ADCs of more than 12 bits saturate
+     amux[i] = 0x0FFF;
+    value[i] = amux[i] - MAX77650_tel.amux[i];
+    if (value[i] < -0x0800 || value[i] > 0x07FF)
+     key = true;
+  }
+  frame[0] = MAX77650_TELEMETRY_SYNC | (key ? MAX77650_TELEMETRY_KEYFLAG : 0) | (MAX77650_tel.sequence & 0b00000111);
+  for (byte i = 0; i < 3; i++)
+   frame[1 + i] = key ? stat[i] : stat[i] ^ MAX77650_tel.stat[i];
+  frame[4] = MAX77650_tel.INT_GLBL;
+  frame[5] = MAX77650_tel.INT_CHG;
+  frame[6] = MAX77650_tel.irqs;
+  for (byte i = 0; i < MAX77650_TELEMETRY_CHANNELS; i += 2){   //two channels in 3 bytes
+    unsigned int a = (key ? amux[i] : value[i]) & 0x0FFF, b = (key ? amux[i + 1] : value[i + 1]) & 0x0FFF;   //deltas as 12-bit two's complement
+    frame[7 + i / 2 * 3] = a >> 4;
+    frame[8 + i / 2 * 3] = (a << 4) | (b >> 8);
+    frame[9 + i / 2 * 3] = b;
+  }
+  frame[13] = MAX77650_crc8(frame, 13);
+  memcpy(MAX77650_tel.stat, stat, 3);
+  memcpy(MAX77650_tel.amux, amux, sizeof(amux));
+  MAX77650_tel.INT_GLBL = MAX77650_tel.INT_CHG = MAX77650_tel.irqs = 0;
+  MAX77650_tel.to_key = key ? MAX77650_TELEMETRY_KEY - 1 : MAX77650_tel.to_key - 1;
+  MAX77650_tel.sequence++;
+  return true;
+}
+
+boolean MAX77650_telemetry_decode(const byte *frame, MAX77650_telemetry &state){ //Applies a frame to the state of a decoder
+  boolean key = frame[0] & MAX77650_TELEMETRY_KEYFLAG;
+  byte sequence = frame[0] & 0b00000111;
+  if ((frame[0] & 0b11110000) != MAX77650_TELEMETRY_SYNC || frame[13] != MAX77650_crc8(frame, 13) 
+      || (!key && (!state.synced || sequence != ((state.sequence + 1) & 0b00000111)))){
+    state.synced = false;   //deltas only apply to the frame before
+    return false;
+  }
+  state.STAT_CHG_A = key ? frame[1] : state.STAT_CHG_A ^ frame[1];
+  state.STAT_CHG_B = key ? frame[2] : state.STAT_CHG_B ^ frame[2];
+  state.STAT_GLBL = key ? frame[3] : state.STAT_GLBL ^ frame[3];
+  state.INT_GLBL = frame[4];
+  state.INT_CHG = frame[5];
+  state.irqs = frame[6];
+  for (byte i = 0; i < MAX77650_TELEMETRY_CHANNELS; i++){
+    const byte *p = frame + 7 + i / 2 * 3;
+    int value = (i & 1) ? ((p[1] & 0x0F) << 8) | p[2] : (p[0] << 4) | (p[1] >> 4);
+    state.amux[i] = key ? value : state.amux[i] + ((value ^ 0x0800) - 0x0800);
+  }
+  state.sequence = sequence;
+  state.key = key;
+  state.synced = true;
+  return true;
+}
+
+
+//***** Fault log *****
+
+static struct {
+  MAX77650_fault ring[MAX77650_FAULTLOG_LEN];
+  byte head;                                      //oldest entry
+  byte count;                                     //entries in the ring
+  byte pending;                                   //newest entries not handed to the flush function yet
+  byte page;
+  uint16_t sequence;                              //of the next event
+  unsigned int lost;
+  boolean (*flush)(const MAX77650_fault*, byte);
+  boolean enabled;
+} MAX77650_faults;
+
+static void MAX77650_faultlog_add(byte type, byte data, unsigned long time){
+  byte i;
+  if (MAX77650_faults.count < MAX77650_FAULTLOG_LEN)
+   i = (MAX77650_faults.head + MAX77650_faults.count++) % MAX77650_FAULTLOG_LEN;
+  else {
+    i = MAX77650_faults.head;   //overwrites the oldest entry
+    MAX77650_faults.head = (MAX77650_faults.head + 1) % MAX77650_FAULTLOG_LEN;
+  }
+  if (MAX77650_faults.flush){
+    if (MAX77650_faults.pending < MAX77650_FAULTLOG_LEN)
+     MAX77650_faults.pending++;
+    else
+     MAX77650_faults.lost++;
+  }
+  MAX77650_fault &fault = MAX77650_faults.ring[i];
+  fault.time = time;
+  fault.sequence = MAX77650_faults.sequence++;
+  fault.type = type;
+  fault.data = data;
+}
+
+static boolean MAX77650_faultlog_handover(byte min){ //hands the oldest new entries, at most one page, if there are min of them
+  if (!MAX77650_faults.flush || !MAX77650_faults.pending || MAX77650_faults.pending < min)
+   return false;
+  byte first = (MAX77650_faults.head + MAX77650_faults.count - MAX77650_faults.pending) % MAX77650_FAULTLOG_LEN;
+  byte n = (MAX77650_faults.pending < MAX77650_faults.page) ? MAX77650_faults.pending : MAX77650_faults.page;
+  if (first + n > MAX77650_FAULTLOG_LEN)
+   n = MAX77650_FAULTLOG_LEN - first;   //the rest follows from the start of the ring
+  if (!MAX77650_faults.flush(&MAX77650_faults.ring[first], n))
+   return false;
+  MAX77650_faults.pending -= n;
+  return true;
+}
+
+static void MAX77650_faultlog_service(const MAX77650_irq_snapshot &irq){
+  if (!MAX77650_faults.enabled)
+   return;
+  if (irq.INT_GLBL & MAX77650_INT_GLBL_TJAL1_R)
+   MAX77650_faultlog_add(MAX77650_FAULT_TJAL1, 0, irq.time);
+  if (irq.INT_GLBL & MAX77650_INT_GLBL_TJAL2_R)
+   MAX77650_faultlog_add(MAX77650_FAULT_TJAL2, 0, irq.time);
+  if (irq.INT_CHG & MAX77650_INT_CHG_TJ_REG_I)
+   MAX77650_faultlog_add(MAX77650_FAULT_TJ_REG, (irq.STAT_CHG_A >> 3) & 0b00000001, irq.time);
+  if (irq.INT_CHG & MAX77650_INT_CHG_SYS_CNFG_I)
+   MAX77650_faultlog_add(MAX77650_FAULT_SYS_CNFG, 0, irq.time);
+  if (irq.INT_CHG & MAX77650_INT_CHG_SYS_CTRL_I)
+   MAX77650_faultlog_add(MAX77650_FAULT_VSYS_MIN, (irq.STAT_CHG_A >> 4) & 0b00000001, irq.time);
+  if (irq.INT_CHG & MAX77650_INT_CHG_CHGIN_I)
+   MAX77650_faultlog_add(MAX77650_FAULT_CHGIN, (irq.STAT_CHG_B >> 2) & 0b00000011, irq.time);
+  if (irq.INT_GLBL & MAX77650_INT_GLBL_DOD_R)
+   MAX77650_faultlog_add(MAX77650_FAULT_DROPOUT, 0, irq.time);
+}
+
+boolean MAX77650_faultlog_begin(boolean (*flush)(const MAX77650_fault*, byte), byte page, uint16_t sequence){ //Starts the log
+  MAX77650_faults.flush = flush;
+  MAX77650_faults.page = (page && page <= MAX77650_FAULTLOG_LEN) ? page : MAX77650_FAULTLOG_LEN;
+  MAX77650_faults.sequence = sequence;
+  MAX77650_faults.head = MAX77650_faults.count = MAX77650_faults.pending = 0;
+  MAX77650_faults.lost = 0;
+  int flags = MAX77650_read_register(MAX77650_ERCFLAG_ADDR);   //cleared by reading
+  if (flags < 0)
+   return false;
+  MAX77650_faults.enabled = true;
+  if (flags)
+   MAX77650_faultlog_add(MAX77650_FAULT_RESET, flags, millis());
+  const byte glbl = MAX77650_INT_GLBL_TJAL1_R | MAX77650_INT_GLBL_TJAL2_R | MAX77650_INT_GLBL_DOD_R;
+  const byte chg = MAX77650_INT_CHG_TJ_REG_I | MAX77650_INT_CHG_SYS_CNFG_I | MAX77650_INT_CHG_SYS_CTRL_I | MAX77650_INT_CHG_CHGIN_I;
+  return MAX77650_PMIC.updateRegister(MAX77650_INTM_GLBL_ADDR, glbl, 0) && MAX77650_PMIC.updateRegister(MAX77650_INT_M_CHG_ADDR, chg, 0);
+}
+
+void MAX77650_faultlog_tick(void){ //Hands a complete page of new entries to the flush function
+  MAX77650_faultlog_handover(MAX77650_faults.page);
+}
+
+boolean MAX77650_faultlog_flush(void){ //Hands all new entries to the flush function
+  while (MAX77650_faults.pending)
+   if (!MAX77650_faultlog_handover(1))
+    return false;
+  return true;
+}
+
+byte MAX77650_faultlog_count(void){ //Returns the number of entries in the ring
+  return MAX77650_faults.count;
+}
+
+boolean MAX77650_faultlog_get(byte index, MAX77650_fault &fault){ //Copies an entry, 0=oldest
+  if (index >= MAX77650_faults.count)
+   return false;
+  fault = MAX77650_faults.ring[(MAX77650_faults.head + index) % MAX77650_FAULTLOG_LEN];
+  return true;
+}
+
+unsigned int MAX77650_faultlog_lost(void){ //Returns the number of entries overwritten before they were handed over
+  return MAX77650_faults.lost;
+}
+
+
+//***** Thermal throttling *****
+
+#define MAX77650_THROTTLE_FIELDS 7
+
+static const MAX77650_field *const MAX77650_throttle_fields[MAX77650_THROTTLE_FIELDS] = {
+  &MAX77650_FIELD_CHG_CC, &MAX77650_FIELD_BRT_LED0, &MAX77650_FIELD_BRT_LED1, &MAX77650_FIELD_BRT_LED2, 
+  &MAX77650_FIELD_TV_SBB0, &MAX77650_FIELD_TV_SBB1, &MAX77650_FIELD_TV_SBB2
+};
+
+static struct {
+  const MAX77650_throttle_level *table;
+  unsigned long hold_ms;
+  void (*report)(byte);
+  byte level;
+  byte setting[MAX77650_THROTTLE_FIELDS];         //values to restore
+  byte applied[MAX77650_THROTTLE_FIELDS];         //values written for the level
+  unsigned long calm;                             //millis() since the alarms of the level are clear
+  unsigned long polled;                           //millis() of the last poll
+  boolean enabled;
+} MAX77650_throttle;
+
+static byte MAX77650_throttle_target(byte i, byte level){ //value of field i at the level
+  byte target = MAX77650_throttle.setting[i];
+  for (byte l = 0; l < level; l++){
+    const MAX77650_throttle_level &action = MAX77650_throttle.table[l];
+    if (i >= 4){
+      //the SBB1 codes of the MAX77651 do not rise with the voltage: compared as voltages
+      byte code = action.TV_SBB[i - 4], reg = MAX77650_throttle_fields[i]->reg;
+      if (code != 0xFF && MAX77650_PMIC.codeToVoltage(reg, code) < MAX77650_PMIC.codeToVoltage(reg, target))
+       target = code;
+      continue;
+    }
+    unsigned int code = (i == 0) ? action.CHG_CC : (unsigned int)MAX77650_throttle.setting[i] * action.brightness / 100;
+    if (code < target)
+     target = code;
+  }
+  return target;
+}
+
+static boolean MAX77650_throttle_apply(byte level){ //writes the fields of the level in one applyConfig
+  MAX77650_guard guard(MAX77650_PMIC.getLock(), (1 << MAX77650_GROUP_CHARGER) | (1 << MAX77650_GROUP_SBB) | (1 << MAX77650_GROUP_LED));
+  MAX77650_config config;
+  byte cc = 0xFF;
+  for (byte l = 0; l < level; l++)
+   if (MAX77650_throttle.table[l].CHG_CC < cc)
+    cc = MAX77650_throttle.table[l].CHG_CC;
+  for (byte i = 0; i < MAX77650_THROTTLE_FIELDS; i++){
+    if (!i && MAX77650_chgctrl.enabled)
+     continue;   //the charge-current controller owns CHG_CC: throttled through its ceiling
+    const MAX77650_field &field = *MAX77650_throttle_fields[i];
+    int value = MAX77650_PMIC.getShadow(field.reg);
+    if (value < 0 && (value = MAX77650_PMIC.readRegister(field.reg)) < 0)
+     return false;
+    value = (value >> field.shift) & field.mask;
+    if (!MAX77650_throttle.level || value != MAX77650_throttle.applied[i])
+     MAX77650_throttle.setting[i] = value;   //not throttled yet or changed by the application meanwhile
+    MAX77650_throttle.applied[i] = MAX77650_throttle_target(i, level);
+    config.set(field, MAX77650_throttle.applied[i]);
+  }
+  if (MAX77650_PMIC.applyConfig(config) < 0)
+   return false;
+  MAX77650_chargeController_throttle(level && cc != 0xFF, cc);   //also holds if the controller is started later
+  MAX77650_LOG(MAX77650_LOG_INFO, MAX77650_MSG_THROTTLE, level, MAX77650_throttle.level);
+  MAX77650_throttle.level = level;
+  MAX77650_throttle.calm = MAX77650_throttle.polled = millis();
+  if (MAX77650_throttle.report)
+   MAX77650_throttle.report(level);
+  return true;
+}
+
+static void MAX77650_throttle_service(const MAX77650_irq_snapshot &irq){
+  if (!MAX77650_throttle.enabled)
+   return;
+  byte level = 0;
+  if (irq.INT_GLBL & MAX77650_INT_GLBL_TJAL2_R)
+   level = 2;
+  else if ((irq.INT_GLBL & MAX77650_INT_GLBL_TJAL1_R) || ((irq.INT_CHG & MAX77650_INT_CHG_TJ_REG_I) && (irq.STAT_CHG_A & MAX77650_STAT_CHG_A_TJ_REG)))
+   level = 1;
+  if (level > MAX77650_throttle.level)
+   MAX77650_throttle_apply(level);
+  else if (level && level == MAX77650_throttle.level)
+   MAX77650_throttle.calm = irq.time;
+}
+
+boolean MAX77650_throttle_begin(const MAX77650_throttle_level *table, unsigned long hold_ms, void (*report)(byte)){ //Starts the controller
+  MAX77650_throttle.table = table;
+  MAX77650_throttle.hold_ms = hold_ms;
+  MAX77650_throttle.report = report;
+  MAX77650_throttle.level = 0;
+  MAX77650_throttle.enabled = true;
+  return MAX77650_PMIC.updateRegister(MAX77650_INTM_GLBL_ADDR, MAX77650_INT_GLBL_TJAL1_R | MAX77650_INT_GLBL_TJAL2_R, 0) 
+         && MAX77650_PMIC.updateRegister(MAX77650_INT_M_CHG_ADDR, MAX77650_INT_CHG_TJ_REG_I, 0);
+}
+
+void MAX77650_throttle_end(void){ //Restores the settings and stops the controller
+  if (MAX77650_throttle.level)
+   MAX77650_throttle_apply(0);
+  MAX77650_throttle.enabled = false;
+}
+
+void MAX77650_throttle_tick(void){ //Polls the alarms only while throttled
+  if (!MAX77650_throttle.enabled || !MAX77650_throttle.level || millis() - MAX77650_throttle.polled < MAX77650_THROTTLE_POLL_MS)
+   return;
+  MAX77650_throttle.polled = millis();
+  int glbl = MAX77650_read_register(MAX77650_STAT_GLBL_ADDR);
+  int chg = MAX77650_read_register(MAX77650_STAT_CHG_A_ADDR);
+  if (glbl < 0 || chg < 0)
+   return;
+  byte level = (glbl & 0b00010000) ? 2 : ((glbl & 0b00001000) || (chg & MAX77650_STAT_CHG_A_TJ_REG)) ? 1 : 0;   //TJAL2, TJAL1, TJ_REG_STAT
+  if (level >= MAX77650_throttle.level){
+    MAX77650_throttle.calm = MAX77650_throttle.polled;
+    if (level > MAX77650_throttle.level)
+     MAX77650_throttle_apply(level);   //rising edge missed
+  }
+  else if (MAX77650_throttle.polled - MAX77650_throttle.calm >= MAX77650_throttle.hold_ms)
+   MAX77650_throttle_apply(MAX77650_throttle.level - 1);
+}
+
+byte MAX77650_throttle_getLevel(void){ //Returns the level in effect
+  return MAX77650_throttle.level;
+}
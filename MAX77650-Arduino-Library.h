@@ -40,14 +40,52 @@
 * 1.0.0	   14.03.2018	     code-review and finished work
 * 1.0.1	   22.03.2018      bugfix: fixed address of register in function MAX77650_getCID; added two more examples
 * 1.0.2       23.09.2018      changed wire-calls to preprocessor directives; 
+* 1.1.0       18.10.2026      added burst register access and charger profiles (CNFG_CHG_A..I in one burst write)
+* 1.2.0       18.10.2026      added interrupt service and adaptive charge-current controller
+* 1.3.0       18.10.2026      added AMUX measurements, thermistor temperature and JEITA charging supervisor
+* 1.4.0       18.10.2026      added driver objects (one per PMIC) with register shadow and field descriptors; bugfix: MAX77650_read_register returned no value, MAX77650_write_register wrote twice
+* 1.5.0       18.10.2026      added transports: Arduino Wire, Linux i2c-dev and simulator
+* 1.6.0       18.10.2026      setters write through the register shadow: no read before a write, no write of unchanged values
+* 1.7.0       18.10.2026      added configurations applied with the minimum of burst writes
+* 1.8.0       18.10.2026      added configuration snapshots for warm boots
+* 1.9.0       18.10.2026      added register scrubber repairing registers diverged from the shadow
+* 1.10.0      18.10.2026      added typed I2C errors, repetitions with backoff and a time bound per transfer
+* 1.11.0      18.10.2026      added recovery of a stuck I2C bus and watchdog feeding
+* 1.12.0      18.10.2026      added register-group locks for tasks of an RTOS sharing a PMIC
+* 1.13.0      18.10.2026      added a request scheduler with priority classes, deadlines and coalescing of writes
+* 1.14.0      18.10.2026      added a trace recorder of the I2C transfers and a host tool replaying traces (extras)
+* 1.15.0      18.10.2026      added latency histograms per class of PMIC operations (MAX77650_LATENCY_HISTOGRAMS)
+* 1.16.0      18.10.2026      added a shutdown sequencer ordering rail disables, PWR_HLD release and software off
+* 1.17.0      18.10.2026      added nEN button gestures from the nEN interrupts; interrupt snapshots carry the time of the IRQ
+* 1.18.0      18.10.2026      added the GPIO functions configuring the pin in one write and delivering GPI edges
+* 1.19.0      18.10.2026      added an energy estimator of the rails with AMUX correction and power budget; rail voltage converters
+* 1.20.0      18.10.2026      added a delta encoded binary telemetry frame of status, interrupts and AMUX readings with decoder
+* 1.21.0      18.10.2026      added a leveled log ring with deferred formatting (MAX77650_LOG_LEVEL); MAX77650_init no longer prints
+* 1.22.0      18.10.2026      added unit converters of the rail, peak current and LED fields, inverse converters and MAX77650_CODE
+* 1.23.0      18.10.2026      added detection of the part and CID at init and the MAX77651 rail tables
+* 1.24.0      18.10.2026      added a fault log of reset causes and interrupt events with paged flash write-through
+* 1.25.0      18.10.2026      added a thermal throttling controller with graduated actions and hysteresis
 * 
 **********************************************************************/
 
 #ifndef MAX77650_H
 #define MAX77650_H
 
-#include "Arduino.h"
-#include <Wire.h>
+#ifdef ARDUINO
+ #include "Arduino.h"
+ #include <Wire.h>
+#else
+ //Linux hosts, e.g. production test stations; the I2C adapter is used through /dev/i2c-*
+ #include <stdint.h>
+ #include <stddef.h>
+ #include <math.h>
+ typedef uint8_t byte;
+ typedef bool boolean;
+ unsigned long millis(void);
+ unsigned long micros(void);
+ void delay(unsigned long);
+ void delayMicroseconds(unsigned int);
+#endif
 
 /**********************************************************************
 *@brief MAX77650 - The MAX77650/MAX77651 provide highly-integrated battery charging and 
@@ -73,15 +111,37 @@
 
 
 // Project specific definitions *** adapt to your requirements! ***
-#define PMIC_partnumber 0x00  //placed PMIC part-numer on the board: MAX77650 or MAX77651
+#define PMIC_partnumber 0x00  //placed PMIC part-numer on the board: MAX77650 or MAX77651; used until MAX77650_init has detected the part
 #define MAX77650_CID 0x78     //OTP option
 #define MAX77650_ADDR 0x48    //alternate ADDR is 0x40
+#define MAX77650_NTC_BETA 3380  //beta of the battery NTC; its R25 has to match the TBIAS pull-up resistor
 #ifndef MAX77650_debug
 #define MAX77650_debug false
 #endif
 #ifndef MAX77650_I2C_port
 #define MAX77650_I2C_port 2     //I2C port of the host µC
 #endif
+#ifndef MAX77650_VERIFY_WRITES
+#define MAX77650_VERIFY_WRITES true   //setters read a written field back; false saves that read
+#endif
+#ifndef MAX77650_I2C_retries
+#define MAX77650_I2C_retries 2          //repetitions of a failed I2C transfer
+#endif
+#ifndef MAX77650_I2C_backoff_us
+#define MAX77650_I2C_backoff_us 100     //wait before the first repetition, doubled for every further one
+#endif
+#ifndef MAX77650_I2C_timeout_us
+#define MAX77650_I2C_timeout_us 5000    //bound of one I2C transfer including its repetitions
+#endif
+#ifndef MAX77650_I2C_device
+#define MAX77650_I2C_device "/dev/i2c-1"   //I2C adapter of a Linux host
+#endif
+#ifndef MAX77650_LATENCY_HISTOGRAMS
+#define MAX77650_LATENCY_HISTOGRAMS false  //true records latency histograms of the PMIC operations (MAX77650_getHistogram)
+#endif
+#ifndef MAX77650_LOG_LEVEL
+#define MAX77650_LOG_LEVEL 0    //messages kept in the log ring: 0=none (no logging code), 1=errors, 2=+warnings, 3=+info, 4=+debug
+#endif
 
 //***** Begin MAX77650 Register Definitions *****
 #define MAX77650_CNFG_GLBL_ADDR 0x10     //Global Configuration Register; Reset Value OTP                           
@@ -122,12 +182,31 @@
 #define MAX77650_CNFG_LED_TOP_ADDR 0x46  //LED Configuration Register; Reset Value 0x0D; Read/Write
 //***** End MAX77650 Register Definitions *****
 
-boolean MAX77650_init(void);
-int MAX77650_read_register(int);
-byte MAX77650_write_register(int, int);
+//***** Begin MAX77650 Interrupt Bit Definitions *****
+#define MAX77650_INT_GLBL_GPI_F 0b00000001        //GPI Falling Interrupt
+#define MAX77650_INT_GLBL_GPI_R 0b00000010        //GPI Rising Interrupt
+#define MAX77650_INT_GLBL_nEN_F 0b00000100        //nEN Falling Interrupt
+#define MAX77650_INT_GLBL_nEN_R 0b00001000        //nEN Rising Interrupt
+#define MAX77650_INT_GLBL_TJAL1_R 0b00010000      //Thermal Alarm 1 Rising Interrupt
+#define MAX77650_INT_GLBL_TJAL2_R 0b00100000      //Thermal Alarm 2 Rising Interrupt
+#define MAX77650_INT_GLBL_DOD_R 0b01000000        //LDO Dropout Detector Rising Interrupt
+#define MAX77650_INT_CHG_THM_I 0b00000001         //Thermistor related interrupt; THM_DTLS has changed
+#define MAX77650_INT_CHG_CHG_I 0b00000010         //Charger related interrupt; CHG_DTLS has changed
+#define MAX77650_INT_CHG_CHGIN_I 0b00000100       //CHGIN related interrupt; CHGIN_DTLS has changed
+#define MAX77650_INT_CHG_TJ_REG_I 0b00001000      //Die junction temperature regulation interrupt; TJ_REG_STAT has changed
+#define MAX77650_INT_CHG_CHGIN_CTRL_I 0b00010000  //CHGIN control-loop related interrupt; VCHGIN_MIN_STAT or ICHGIN_LIM_STAT has changed
+#define MAX77650_INT_CHG_SYS_CTRL_I 0b00100000    //Minimum System Voltage Regulation-loop related interrupt; VSYS_MIN_STAT has changed
+#define MAX77650_INT_CHG_SYS_CNFG_I 0b01000000    //System voltage configuration error interrupt
+//***** End MAX77650 Interrupt Bit Definitions *****
+
+boolean MAX77650_init(void); //Starts the I2C port of MAX77650_PMIC; Return Value: true=PMIC acknowledged
+int MAX77650_read_register(int); //Reads a register; Return Value: register value; -1=I2C error (see MAX77650_getLastError)
+byte MAX77650_write_register(int, int); //Writes a register in one transaction; Return Value: MAX77650_OK or a MAX77650_error
+boolean MAX77650_read_burst(int, byte*, byte); //Reads consecutive registers starting at ADDR in one I2C transaction; Return Value: true=all bytes received
+boolean MAX77650_write_burst(int, const byte*, byte); //Writes consecutive registers starting at ADDR in one I2C transaction; Return Value: true=transmission acknowledged
 
 //Status Register (STAT_GLBL) related reads
-boolean MAX77650_getDIDM(void); //Returns Part Number; Return Value: 1=MAX77650; 2=MAX77651; -1=error reading DeviceID
+boolean MAX77650_getDIDM(void); //Returns Part Number, detected once by MAX77650_init; Return Value: 0=MAX77650; 1=MAX77651
 boolean MAX77650_getLDO_DropoutDetector(void); //Returns whether the LDO is in Dropout or not; Return Value: 0=LDO is not in dropout; 1=LDO is in dropout
 boolean MAX77650_getThermalAlarm1(void); //Returns Thermal Alarm (TJA1 limit); Return Value: 0=Tj<TJA1; 1=Tj>TJA1
 boolean MAX77650_getThermalAlarm2(void); //Returns Therma2 Alarm (TJA2 limit); Return Value: 0=Tj<TJA2; 1=Tj>TJA2
@@ -397,6 +476,1066 @@ boolean MAX77650_setDIR(boolean); //Sets GPIO Direction
 boolean MAX77650_setINT_M_CHG(byte); //Sets Global Interrupt Mask Register
 
 
+//***** Charger profiles *****
+//A charger profile holds the complete images of the Charger Configuration Registers A..I (0x18..0x20). Profiles are 
+//built from physical units; declared as constexpr every value is range-checked by the compiler (a call of 
+//MAX77650_out_of_range in a constant expression is a compile error). At runtime out of range values are clamped.
+//Applying a profile costs one burst write and one burst read for verification, so the charger is switched atomically.
+//The converters for the fields outside the charger (rails, LEDs) and the inverse converters *_to_* for readback of 
+//register codes are declared alongside. SBB1 and SBB2 of the MAX77651 have other ranges (MAX77651_*); the part 
+//detected by MAX77650_init is cached and selects them in MAX77650::codeToVoltage and voltageToCode. A part known 
+//at compile time selects them by MAX77650_variant<part> (MAX77650_board: the part set by PMIC_partnumber).
+#define MAX77650_PART_MAX77650 0x0      //DIDM of the MAX77650
+#define MAX77650_PART_MAX77651 0x1      //DIDM of the MAX77651
+#define MAX77650_PART_UNKNOWN 0xFF      //part not detected yet
+#define MAX77650_CHG_PROFILE_LEN 9    //number of registers CNFG_CHG_A..CNFG_CHG_I
+
+byte MAX77650_out_of_range(byte); //Called by the unit converters for values out of range; Return Value: the clamped register code
+
+constexpr byte MAX77650_THM_COLD_C(int C){ //VCOLD JEITA threshold; -10°C..5°C in 5°C steps
+  return (C < -10 || C > 5 || (C + 10) % 5) ? MAX77650_out_of_range(C < -10 ? 0 : 3) : (byte)((C + 10) / 5);
+}
+constexpr byte MAX77650_THM_COOL_C(int C){ //VCOOL JEITA threshold; 0°C..15°C in 5°C steps
+  return (C < 0 || C > 15 || C % 5) ? MAX77650_out_of_range(C < 0 ? 0 : 3) : (byte)(C / 5);
+}
+constexpr byte MAX77650_THM_WARM_C(int C){ //VWARM JEITA threshold; 35°C..50°C in 5°C steps
+  return (C < 35 || C > 50 || C % 5) ? MAX77650_out_of_range(C < 35 ? 0 : 3) : (byte)((C - 35) / 5);
+}
+constexpr byte MAX77650_THM_HOT_C(int C){ //VHOT JEITA threshold; 45°C..60°C in 5°C steps
+  return (C < 45 || C > 60 || C % 5) ? MAX77650_out_of_range(C < 45 ? 0 : 3) : (byte)((C - 45) / 5);
+}
+constexpr byte MAX77650_VCHGIN_MIN_mV(unsigned int mV){ //VCHGIN-MIN 4.0V..4.7V in 100mV steps
+  return (mV < 4000 || mV > 4700) ? MAX77650_out_of_range(mV < 4000 ? 0 : 7) : (byte)((mV - 4000) / 100);
+}
+constexpr byte MAX77650_ICHGIN_LIM_mA(unsigned int mA){ //ICHGIN-LIM 95mA..475mA in 95mA steps; rounded down
+  return (mA < 95 || mA > 475) ? MAX77650_out_of_range(mA < 95 ? 0 : 4) : (byte)(mA / 95 - 1);
+}
+constexpr byte MAX77650_I_PQ_percent(unsigned int percent){ //IPQ 10% or 20% of IFAST-CHG
+  return (percent != 10 && percent != 20) ? MAX77650_out_of_range(percent < 20 ? 0 : 1) : (byte)(percent / 10 - 1);
+}
+constexpr byte MAX77650_CHG_PQ_mV(unsigned int mV){ //VPQ 2.3V..3.0V in 100mV steps
+  return (mV < 2300 || mV > 3000) ? MAX77650_out_of_range(mV < 2300 ? 0 : 7) : (byte)((mV - 2300) / 100);
+}
+constexpr byte MAX77650_I_TERM_permille(unsigned int permille){ //ITERM 5%, 7.5%, 10% or 15% of IFAST-CHG given in 0.1%
+  return permille == 50 ? 0 : permille == 75 ? 1 : permille == 100 ? 2 : permille == 150 ? 3 : MAX77650_out_of_range(permille < 50 ? 0 : 3);
+}
+constexpr byte MAX77650_T_TOPOFF_min(unsigned int minutes){ //tTO 0min..35min in 5min steps
+  return (minutes > 35 || minutes % 5) ? MAX77650_out_of_range(minutes > 35 ? 7 : minutes / 5) : (byte)(minutes / 5);
+}
+constexpr byte MAX77650_TJ_REG_C(unsigned int C){ //TJ-REG 60°C..100°C in 10°C steps
+  return (C < 60 || C > 100 || C % 10) ? MAX77650_out_of_range(C < 60 ? 0 : C > 100 ? 4 : (C - 60) / 10) : (byte)((C - 60) / 10);
+}
+constexpr byte MAX77650_VSYS_REG_mV(unsigned int mV){ //VSYS-REG 4.1V..4.7V in 25mV steps; rounded down
+  return (mV < 4100 || mV > 4700) ? MAX77650_out_of_range(mV < 4100 ? 0x00 : 0x18) : (byte)((mV - 4100) / 25);
+}
+constexpr byte MAX77650_CHG_CC_mA(unsigned int mA){ //IFAST-CHG and IFAST-CHG_JEITA 7.5mA..300mA in 7.5mA steps; rounded down
+  return (mA < 8 || mA > 300) ? MAX77650_out_of_range(mA < 8 ? 0x00 : 0x27) : (byte)((mA * 2 - 15) / 15);
+}
+constexpr byte MAX77650_T_FAST_CHG_h(unsigned int hours){ //tFC 3h, 5h or 7h; 0=timer disabled
+  return hours == 0 ? 0 : hours == 3 ? 1 : hours == 5 ? 2 : hours == 7 ? 3 : MAX77650_out_of_range(hours < 5 ? 1 : hours < 7 ? 2 : 3);
+}
+constexpr byte MAX77650_CHG_CV_mV(unsigned int mV){ //VFAST-CHG and VFAST-CHG_JEITA 3.6V..4.6V in 25mV steps; rounded down
+  return (mV < 3600 || mV > 4600) ? MAX77650_out_of_range(mV < 3600 ? 0x00 : 0x28) : (byte)((mV - 3600) / 25);
+}
+constexpr byte MAX77650_TV_SBB0_mV(unsigned int mV){ //SBB0 target voltage 0.8V..2.375V in 25mV steps; rounded down
+  return (mV < 800 || mV > 2375) ? MAX77650_out_of_range(mV < 800 ? 0x00 : 0x3F) : (byte)((mV - 800) / 25);
+}
+constexpr byte MAX77650_TV_SBB1_mV(unsigned int mV){ //SBB1 target voltage 0.8V..1.5875V in 12.5mV steps; rounded down
+  return (mV < 800 || mV > 1587) ? MAX77650_out_of_range(mV < 800 ? 0x00 : 0x3F) : (byte)((mV - 800) * 2 / 25);
+}
+constexpr byte MAX77650_TV_SBB2_mV(unsigned int mV){ //SBB2 target voltage 0.8V..3.95V in 50mV steps; rounded down
+  return (mV < 800 || mV > 3950) ? MAX77650_out_of_range(mV < 800 ? 0x00 : 0x3F) : (byte)((mV - 800) / 50);
+}
+constexpr byte MAX77650_TV_LDO_mV(unsigned int mV){ //LDO target voltage 1.35V..2.9375V in 12.5mV steps; rounded down
+  return (mV < 1350 || mV > 2937) ? MAX77650_out_of_range(mV < 1350 ? 0x00 : 0x7F) : (byte)((mV - 1350) * 2 / 25);
+}
+constexpr byte MAX77651_TV_SBB1_mV(unsigned int mV){ //MAX77651 SBB1 target voltage 2.4V..5.55V in 50mV steps above 2.4V, 3.2V, 4.0V or 4.8V; rounded down
+  return (mV < 2400 || mV > 5550) ? MAX77650_out_of_range(mV < 2400 ? 0x00 : 0x3F) : (byte)(((mV - 2400) % 800 / 50 > 15 ? 15 : (mV - 2400) % 800 / 50) << 2 | (mV - 2400) / 800);
+}
+constexpr byte MAX77651_TV_SBB2_mV(unsigned int mV){ //MAX77651 SBB2 target voltage 2.4V..5.55V in 50mV steps; rounded down
+  return (mV < 2400 || mV > 5550) ? MAX77650_out_of_range(mV < 2400 ? 0x00 : 0x3F) : (byte)((mV - 2400) / 50);
+}
+constexpr byte MAX77650_IP_SBB_mA(unsigned int mA){ //SBB peak current limit 1000mA, 750mA, 500mA or 250mA
+  return (mA < 250 || mA > 1000 || mA % 250) ? MAX77650_out_of_range(mA < 250 ? 3 : mA > 1000 ? 0 : 4 - mA / 250) : (byte)(4 - mA / 250);
+}
+constexpr byte MAX77650_P_LED_ms(unsigned int ms){ //LED period 512ms..7680ms in 512ms steps; 0=always on
+  return ms == 0 ? 0x0F : (ms < 512 || ms > 7680 || ms % 512) ? MAX77650_out_of_range(ms < 512 ? 0x00 : ms > 7680 ? 0x0E : ms / 512 - 1) : (byte)(ms / 512 - 1);
+}
+constexpr byte MAX77650_D_LED_percent(unsigned int percent){ //LED on duty-cycle 6.25%..100% in 6.25% steps; rounded to the nearest step
+  return (percent < 6 || percent > 100) ? MAX77650_out_of_range(percent < 6 ? 0x00 : 0x0F) : (byte)((percent * 16 + 50) / 100 - 1);
+}
+constexpr int MAX77650_THM_COLD_to_C(byte code){ return -10 + 5 * (code & 0b11); } //VCOLD JEITA threshold in °C
+constexpr int MAX77650_THM_COOL_to_C(byte code){ return 5 * (code & 0b11); }       //VCOOL JEITA threshold in °C
+constexpr int MAX77650_THM_WARM_to_C(byte code){ return 35 + 5 * (code & 0b11); }  //VWARM JEITA threshold in °C
+constexpr int MAX77650_THM_HOT_to_C(byte code){ return 45 + 5 * (code & 0b11); }   //VHOT JEITA threshold in °C
+constexpr unsigned int MAX77650_TV_SBB0_to_mV(byte code){ return 800 + 25 * (code & 0b00111111); }          //SBB0 0.8V + 25mV per code
+constexpr unsigned int MAX77650_TV_SBB1_to_mV(byte code){ return 800 + (25 * (code & 0b00111111)) / 2; }    //SBB1 0.8V + 12.5mV per code; rounded down
+constexpr unsigned int MAX77650_TV_SBB2_to_mV(byte code){ return 800 + 50 * (code & 0b00111111); }          //SBB2 0.8V + 50mV per code
+constexpr unsigned int MAX77650_TV_LDO_to_mV(byte code){ return 1350 + (25 * (code & 0b01111111)) / 2; }    //LDO 1.35V + 12.5mV per code; rounded down
+constexpr unsigned int MAX77651_TV_SBB1_to_mV(byte code){ return 2400 + 800 * (code & 0b11) + 50 * ((code >> 2) & 0b1111); } //MAX77651 SBB1 2.4V, 3.2V, 4.0V or 4.8V (bits 1..0) + 50mV per code of bits 5..2
+constexpr unsigned int MAX77651_TV_SBB2_to_mV(byte code){ return 2400 + 50 * (code & 0b00111111); }         //MAX77651 SBB2 2.4V + 50mV per code
+constexpr unsigned int MAX77650_VCHGIN_MIN_to_mV(byte code){ return 4000 + 100 * (code & 0b111); }     //VCHGIN-MIN in mV
+constexpr unsigned int MAX77650_ICHGIN_LIM_to_mA(byte code){ return (code & 0b111) > 4 ? 475 : 95 * ((code & 0b111) + 1); } //ICHGIN-LIM in mA
+constexpr unsigned int MAX77650_I_PQ_to_percent(byte code){ return (code & 0b1) ? 20 : 10; }          //IPQ in % of IFAST-CHG
+constexpr unsigned int MAX77650_CHG_PQ_to_mV(byte code){ return 2300 + 100 * (code & 0b111); }        //VPQ in mV
+constexpr unsigned int MAX77650_I_TERM_to_permille(byte code){ return (code & 0b11) == 3 ? 150 : 50 + 25 * (code & 0b11); } //ITERM in 0.1% of IFAST-CHG
+constexpr unsigned int MAX77650_T_TOPOFF_to_min(byte code){ return 5 * (code & 0b111); }              //tTO in minutes
+constexpr unsigned int MAX77650_TJ_REG_to_C(byte code){ return (code & 0b111) > 4 ? 100 : 60 + 10 * (code & 0b111); } //TJ-REG in °C
+constexpr unsigned int MAX77650_VSYS_REG_to_mV(byte code){ return (code & 0b11111) > 0x18 ? 4700 : 4100 + 25 * (code & 0b11111); } //VSYS-REG in mV
+constexpr unsigned int MAX77650_CHG_CC_to_mA(byte code){ return (code & 0b111111) > 0x27 ? 300 : 15 * ((code & 0b111111) + 1) / 2; } //IFAST-CHG in mA; rounded down
+constexpr unsigned int MAX77650_T_FAST_CHG_to_h(byte code){ return (code & 0b11) ? 1 + 2 * (code & 0b11) : 0; } //tFC in hours; 0=timer disabled
+constexpr unsigned int MAX77650_CHG_CV_to_mV(byte code){ return (code & 0b111111) > 0x28 ? 4600 : 3600 + 25 * (code & 0b111111); } //VFAST-CHG in mV
+constexpr unsigned int MAX77650_IP_SBB_to_mA(byte code){ return 1000 - 250 * (code & 0b11); }         //SBB peak current limit in mA
+constexpr unsigned int MAX77650_P_LED_to_ms(byte code){ return (code & 0b1111) == 0x0F ? 0 : 512 * ((code & 0b1111) + 1); } //LED period in ms; 0=always on
+constexpr unsigned int MAX77650_D_LED_to_permille(byte code){ return 625 * ((code & 0b1111) + 1) / 10; } //LED on duty-cycle in 0.1%; rounded down
+constexpr unsigned int MAX77650_IMON_DISCHG_SCALE_table[] = {82, 405, 723, 1034, 1341, 1641, 1937, 2227, 2512, 2793, 3000}; //full-scale values in 0.1mA
+constexpr byte MAX77650_IMON_DISCHG_SCALE_mA(unsigned int mA, byte code = 0){ //smallest discharge current full-scale covering mA; 8.2mA..300mA
+  return mA > 300 ? MAX77650_out_of_range(0x0A) : (code >= 0x0A || MAX77650_IMON_DISCHG_SCALE_table[code] >= mA * 10) ? code : MAX77650_IMON_DISCHG_SCALE_mA(mA, code + 1);
+}
+constexpr unsigned int MAX77650_IMON_DISCHG_SCALE_to_dmA(byte code){ return MAX77650_IMON_DISCHG_SCALE_table[(code & 0b1111) > 0x0A ? 0x0A : (code & 0b1111)]; } //discharge current full-scale in 0.1mA
+
+//Forces the conversion to be evaluated by the compiler, also as argument of a setter: 
+//MAX77650_setTV_SBB0(MAX77650_CODE(MAX77650_TV_SBB0_mV(1800))) does not compile for a voltage out of range.
+template <byte code> struct MAX77650_constant { static constexpr byte value = code; };
+#define MAX77650_CODE(conversion) (MAX77650_constant<(conversion)>::value)
+
+template <byte part> struct MAX77650_variant { //rail converters of the MAX77650
+  static constexpr byte TV_SBB0_mV(unsigned int mV){ return MAX77650_TV_SBB0_mV(mV); }
+  static constexpr byte TV_SBB1_mV(unsigned int mV){ return MAX77650_TV_SBB1_mV(mV); }
+  static constexpr byte TV_SBB2_mV(unsigned int mV){ return MAX77650_TV_SBB2_mV(mV); }
+  static constexpr byte TV_LDO_mV(unsigned int mV){ return MAX77650_TV_LDO_mV(mV); }
+  static constexpr unsigned int TV_SBB0_to_mV(byte code){ return MAX77650_TV_SBB0_to_mV(code); }
+  static constexpr unsigned int TV_SBB1_to_mV(byte code){ return MAX77650_TV_SBB1_to_mV(code); }
+  static constexpr unsigned int TV_SBB2_to_mV(byte code){ return MAX77650_TV_SBB2_to_mV(code); }
+  static constexpr unsigned int TV_LDO_to_mV(byte code){ return MAX77650_TV_LDO_to_mV(code); }
+};
+
+template <> struct MAX77650_variant<MAX77650_PART_MAX77651> { //rail converters of the MAX77651
+  static constexpr byte TV_SBB0_mV(unsigned int mV){ return MAX77650_TV_SBB0_mV(mV); }
+  static constexpr byte TV_SBB1_mV(unsigned int mV){ return MAX77651_TV_SBB1_mV(mV); }
+  static constexpr byte TV_SBB2_mV(unsigned int mV){ return MAX77651_TV_SBB2_mV(mV); }
+  static constexpr byte TV_LDO_mV(unsigned int mV){ return MAX77650_TV_LDO_mV(mV); }
+  static constexpr unsigned int TV_SBB0_to_mV(byte code){ return MAX77650_TV_SBB0_to_mV(code); }
+  static constexpr unsigned int TV_SBB1_to_mV(byte code){ return MAX77651_TV_SBB1_to_mV(code); }
+  static constexpr unsigned int TV_SBB2_to_mV(byte code){ return MAX77651_TV_SBB2_to_mV(code); }
+  static constexpr unsigned int TV_LDO_to_mV(byte code){ return MAX77650_TV_LDO_to_mV(code); }
+};
+
+typedef MAX77650_variant<PMIC_partnumber> MAX77650_board; //rail converters of the part on the board
+
+struct MAX77650_charger_profile {
+  byte reg[MAX77650_CHG_PROFILE_LEN]; //register images of CNFG_CHG_A..CNFG_CHG_I
+  
+  //Reset values; CNFG_CHG_B is OTP programmed, the profile starts with 4.0V/95mA input limits and the charger disabled
+  constexpr MAX77650_charger_profile() : reg{0x0F, 0x00, 0xF8, 0x10, 0x05, 0x04, 0x00, 0x00, 0xF0} {}
+  constexpr MAX77650_charger_profile(byte a, byte b, byte c, byte d, byte e, byte f, byte g, byte h, byte i) : reg{a, b, c, d, e, f, g, h, i} {}
+
+  //Returns a copy of the profile with the field (mask) of register index replaced by value
+  constexpr MAX77650_charger_profile with(byte index, byte mask, byte value) const {
+    return MAX77650_charger_profile(merge(0, index, mask, value), merge(1, index, mask, value), merge(2, index, mask, value), 
+                                    merge(3, index, mask, value), merge(4, index, mask, value), merge(5, index, mask, value), 
+                                    merge(6, index, mask, value), merge(7, index, mask, value), merge(8, index, mask, value));
+  }
+  constexpr byte merge(byte n, byte index, byte mask, byte value) const {
+    return (n == index) ? (byte)((reg[n] & ~mask) | (value & mask)) : reg[n];
+  }
+
+  //CNFG_CHG_A 0x18
+  constexpr MAX77650_charger_profile THM_HOT_C(int C) const { return with(0, 0b11000000, MAX77650_THM_HOT_C(C) << 6); }
+  constexpr MAX77650_charger_profile THM_WARM_C(int C) const { return with(0, 0b00110000, MAX77650_THM_WARM_C(C) << 4); }
+  constexpr MAX77650_charger_profile THM_COOL_C(int C) const { return with(0, 0b00001100, MAX77650_THM_COOL_C(C) << 2); }
+  constexpr MAX77650_charger_profile THM_COLD_C(int C) const { return with(0, 0b00000011, MAX77650_THM_COLD_C(C) << 0); }
+  //CNFG_CHG_B 0x19
+  constexpr MAX77650_charger_profile VCHGIN_MIN_mV(unsigned int mV) const { return with(1, 0b11100000, MAX77650_VCHGIN_MIN_mV(mV) << 5); }
+  constexpr MAX77650_charger_profile ICHGIN_LIM_mA(unsigned int mA) const { return with(1, 0b00011100, MAX77650_ICHGIN_LIM_mA(mA) << 2); }
+  constexpr MAX77650_charger_profile I_PQ_percent(unsigned int percent) const { return with(1, 0b00000010, MAX77650_I_PQ_percent(percent) << 1); }
+  constexpr MAX77650_charger_profile CHG_EN(boolean enable) const { return with(1, 0b00000001, enable ? 1 : 0); }
+  //CNFG_CHG_C 0x1A
+  constexpr MAX77650_charger_profile CHG_PQ_mV(unsigned int mV) const { return with(2, 0b11100000, MAX77650_CHG_PQ_mV(mV) << 5); }
+  constexpr MAX77650_charger_profile I_TERM_permille(unsigned int permille) const { return with(2, 0b00011000, MAX77650_I_TERM_permille(permille) << 3); }
+  constexpr MAX77650_charger_profile T_TOPOFF_min(unsigned int minutes) const { return with(2, 0b00000111, MAX77650_T_TOPOFF_min(minutes) << 0); }
+  //CNFG_CHG_D 0x1B
+  constexpr MAX77650_charger_profile TJ_REG_C(unsigned int C) const { return with(3, 0b11100000, MAX77650_TJ_REG_C(C) << 5); }
+  constexpr MAX77650_charger_profile VSYS_REG_mV(unsigned int mV) const { return with(3, 0b00011111, MAX77650_VSYS_REG_mV(mV) << 0); }
+  //CNFG_CHG_E 0x1C
+  constexpr MAX77650_charger_profile CHG_CC_mA(unsigned int mA) const { return with(4, 0b11111100, MAX77650_CHG_CC_mA(mA) << 2); }
+  constexpr MAX77650_charger_profile T_FAST_CHG_h(unsigned int hours) const { return with(4, 0b00000011, MAX77650_T_FAST_CHG_h(hours) << 0); }
+  //CNFG_CHG_F 0x1D
+  constexpr MAX77650_charger_profile CHG_CC_JEITA_mA(unsigned int mA) const { return with(5, 0b11111100, MAX77650_CHG_CC_mA(mA) << 2); }
+  constexpr MAX77650_charger_profile THM_EN(boolean enable) const { return with(5, 0b00000010, enable ? 0b10 : 0); }
+  //CNFG_CHG_G 0x1E
+  constexpr MAX77650_charger_profile CHG_CV_mV(unsigned int mV) const { return with(6, 0b11111100, MAX77650_CHG_CV_mV(mV) << 2); }
+  constexpr MAX77650_charger_profile USBS(boolean suspend) const { return with(6, 0b00000010, suspend ? 0b10 : 0); }
+  //CNFG_CHG_H 0x1F
+  constexpr MAX77650_charger_profile CHG_CV_JEITA_mV(unsigned int mV) const { return with(7, 0b11111100, MAX77650_CHG_CV_mV(mV) << 2); }
+  //CNFG_CHG_I 0x20
+  constexpr MAX77650_charger_profile IMON_DISCHG_SCALE_mA(unsigned int mA) const { return with(8, 0b11110000, MAX77650_IMON_DISCHG_SCALE_mA(mA) << 4); }
+  constexpr MAX77650_charger_profile MUX_SEL(byte channel) const { return with(8, 0b00001111, channel); }
+};
+
+boolean MAX77650_applyChargerProfile(const MAX77650_charger_profile&); //Writes CNFG_CHG_A..I in one burst and verifies them with one burst read; Return Value: true=profile is active
+boolean MAX77650_getChargerProfile(MAX77650_charger_profile&); //Reads CNFG_CHG_A..I in one burst into the profile
+
+
+//***** Interrupt service *****
+//The interrupt registers are read-clear. MAX77650_serviceInterrupts reads INT_GLBL, INT_CHG, STAT_CHG_A and STAT_CHG_B 
+//in one burst and hands them to the library modules which need them. Attach MAX77650_IRQ to the IRQ pin 
+//(attachInterrupt(pin, MAX77650_IRQ, FALLING)) and call MAX77650_serviceInterrupts from loop() while an interrupt is pending.
+struct MAX77650_irq_snapshot {
+  byte INT_GLBL;    //Global Interrupt Status Register 0x00
+  byte INT_CHG;     //Charger Interrupt Status Register 0x01
+  byte STAT_CHG_A;  //Charger Status Register A 0x02
+  byte STAT_CHG_B;  //Charger Status Register B 0x03
+  unsigned long time; //millis() when the IRQ pin fired (when read without an IRQ pending: when read)
+};
+
+void MAX77650_IRQ(void); //Interrupt service routine for the IRQ pin of the MAX77650
+boolean MAX77650_interruptPending(void); //Returns whether the IRQ pin fired since the last MAX77650_serviceInterrupts
+boolean MAX77650_serviceInterrupts(MAX77650_irq_snapshot* = NULL); //Reads and clears the interrupt registers and runs the library modules; the registers are copied to the snapshot if given; Return Value: true=registers read
+
+
+//***** Adaptive charge-current controller *****
+//Adjusts IFAST-CHG (CHG_CC) and ICHGIN-LIM on CHGIN control-loop and die temperature regulation interrupts:
+// - TJ_REG_STAT engaged: CHG_CC is lowered by 1/8 (at least one step)
+// - VCHGIN_MIN_STAT engaged (the source collapses): ICHGIN_LIM is lowered by one step
+// - ICHGIN_LIM_STAT engaged while VCHGIN is fine (the source has headroom): ICHGIN_LIM is raised by one step
+// - no loop engaged: MAX77650_chargeController_tick raises CHG_CC (then ICHGIN_LIM) by one step after the hold-off time
+//A loop engaging within the hold-off after a raise doubles the hold-off (up to 16x), a quiet hold-off halves it again, 
+//so the controller settles right below the point where the input or thermal regulation starts.
+//While a loop stays engaged the tick re-reads STAT_CHG_A once per hold-off and keeps stepping, since the interrupts only report changes.
+//The tick only compares timestamps; the bus is used when a step or a status read is due.
+boolean MAX77650_chargeController_begin(byte, byte, unsigned long = 10000); //Starts the controller with the ceilings for CHG_CC and ICHGIN_LIM (register codes) and the hold-off time in ms; unmasks TJ_REG_I and CHGIN_CTRL_I
+void MAX77650_chargeController_end(void); //Stops the controller; the last settings stay active
+void MAX77650_chargeController_setCeiling(byte); //Sets the CHG_CC ceiling (register code); a profile applied by the JEITA supervisor or a thermal throttling level with a lower CHG_CC limits the controller to that
+void MAX77650_chargeController_tick(void); //Call from loop(); raises the currents once the hold-off has expired
+byte MAX77650_chargeController_getCHG_CC(void); //Returns the CHG_CC code the controller has set
+byte MAX77650_chargeController_getICHGIN_LIM(void); //Returns the ICHGIN_LIM code the controller has set
+
+
+//***** Analog multiplexer *****
+//The AMUX pin is read by an ADC of the host µC. The library switches MUX_SEL, waits the settling time, calls the 
+//reader function and switches the multiplexer off again to save energy.
+#define MAX77650_MUX_OFF 0x0                //Multiplexer disabled, AMUX is high-impedance
+#define MAX77650_MUX_CHGIN_V 0x1            //CHGIN voltage monitor
+#define MAX77650_MUX_CHGIN_I 0x2            //CHGIN current monitor
+#define MAX77650_MUX_BATT_V 0x3             //BATT voltage monitor
+#define MAX77650_MUX_BATT_CHG_I 0x4         //BATT charge current monitor (valid while charging)
+#define MAX77650_MUX_BATT_DISCHG_I 0x5      //BATT discharge current monitor
+#define MAX77650_MUX_BATT_DISCHG_I_NULL 0x6 //BATT discharge current monitor null (offset) measurement
+#define MAX77650_MUX_THM_V 0x7              //THM voltage monitor
+#define MAX77650_MUX_TBIAS_V 0x8            //TBIAS voltage monitor
+#define MAX77650_MUX_AGND 0x9               //AGND voltage monitor
+#define MAX77650_MUX_SYS_V 0xA              //SYS voltage monitor
+#define MAX77650_TEMP_INVALID -32768        //returned for temperatures which could not be measured
+
+void MAX77650_setAMUXReader(int (*)(void), int, unsigned int = 5); //Sets the ADC reading function for the AMUX pin, its counts at the AMUX full-scale of 1.25V and the settling time in ms
+boolean MAX77650_readAMUX(const byte*, int*, byte); //Measures the given channels in a row and switches the multiplexer off; Return Value: true=all channels measured
+int MAX77650_readAMUX(byte); //Measures one channel; Return Value: ADC counts; -1=no reader or I2C error
+int MAX77650_getThermistorTemp_dC(void); //Returns the battery temperature in 0.1°C from the THM/TBIAS ratio (NTC beta MAX77650_NTC_BETA); MAX77650_TEMP_INVALID=no thermistor or reader
+
+
+//***** JEITA charging supervisor *****
+//Keeps one charger profile per battery temperature zone (index = THM_DTLS) and applies the profile of the new zone with 
+//one burst write when the thermistor interrupt (THM_I) reports a zone change. Nothing is polled while the temperature stays 
+//inside a zone. Moves into a zone with a lower charge rate are applied at once; with an AMUX reader, moves back into a 
+//zone with a higher charge rate wait until the sampled thermistor temperature is the hysteresis inside that zone 
+//(MAX77650_jeita_tick samples only while such a move is pending). A NULL table entry leaves the charger registers unchanged.
+#define MAX77650_THM_DISABLED 0x0   //THM_DTLS: thermistor disabled (THM_EN=0)
+#define MAX77650_THM_COLD 0x1       //THM_DTLS: T < TCOLD
+#define MAX77650_THM_COOL 0x2       //THM_DTLS: TCOLD < T < TCOOL
+#define MAX77650_THM_WARM 0x3       //THM_DTLS: TWARM < T < THOT
+#define MAX77650_THM_HOT 0x4        //THM_DTLS: T > THOT
+#define MAX77650_THM_NORMAL 0x5     //THM_DTLS: TCOOL < T < TWARM
+#define MAX77650_THM_ZONES 6
+
+boolean MAX77650_jeita_begin(const MAX77650_charger_profile* const*, byte = 2, unsigned long = 5000); //Starts the supervisor with a table of MAX77650_THM_ZONES profiles, the hysteresis in °C and the sampling interval in ms of pending moves; unmasks THM_I
+void MAX77650_jeita_end(void); //Stops the supervisor
+void MAX77650_jeita_tick(void); //Call from loop(); samples the thermistor only while a move into a zone with a higher charge rate is pending
+byte MAX77650_jeita_getZone(void); //Returns the zone whose profile is active
+int MAX77650_jeita_getTemp_dC(void); //Returns the last sampled thermistor temperature in 0.1°C
+
+
+//***** nEN button gestures *****
+//Classifies presses of the button at nEN from the nEN falling (press) and rising (release) interrupts, timestamped when 
+//the IRQ pin fires, without polling the PMIC. A press shorter than the long time is a short press, or a double press if 
+//a second press starts within the double time after the release; a release after the long time is a long press; a 
+//button still pressed after the hold time is reported as hold once (by MAX77650_button_tick, which only compares 
+//timestamps and can be skipped while sleeping: a missed hold is reported at the release). With double presses enabled 
+//a short press is reported once the double time has passed (tick or next press). Mind the manual reset of the PMIC 
+//when nEN is held for its reset time.
+#define MAX77650_BTN_NONE 0     //no gesture
+#define MAX77650_BTN_SHORT 1    //short press
+#define MAX77650_BTN_DOUBLE 2   //two short presses
+#define MAX77650_BTN_LONG 3     //press released after the long time
+#define MAX77650_BTN_HOLD 4     //button pressed for the hold time
+
+boolean MAX77650_button_begin(void (*)(byte, unsigned long) = NULL, unsigned int = 800, unsigned int = 300, unsigned int = 3000); //Starts the engine with the callback (gesture, press duration in ms), the long, double and hold times in ms (double 0=no double presses); unmasks nEN_F and nEN_R
+void MAX77650_button_end(void); //Stops the engine
+void MAX77650_button_tick(void); //Call from loop(); reports pending short presses and holds; no I2C
+byte MAX77650_button_getGesture(void); //Returns and clears the last gesture (MAX77650_BTN_*)
+
+
+//***** GPIO *****
+//The GPIO pin is configured by one write of CNFG_GPIO (direction, driver type, debounce and output level together). 
+//Writing or toggling the output costs one write of the cached register, none if the level does not change. GPI edges 
+//are delivered from the GPI falling and rising interrupts with the time the IRQ pin fired, to the callback and 
+//MAX77650_gpio_getEdges; both bits are reported together if both edges happened since the last interrupt service.
+#define MAX77650_GPIO_INPUT 0b00000001        //mode: input (DIR=1)
+#define MAX77650_GPIO_OUTPUT_OD 0b00000000    //mode: open-drain output
+#define MAX77650_GPIO_OUTPUT_PP 0b00000100    //mode: push-pull output (DRV=1)
+#define MAX77650_GPIO_HIGH 0b00001000         //mode: output level high (DO=1)
+#define MAX77650_GPIO_DEBOUNCE 0b00010000     //mode: 30ms debounce of the input (DBEN_GPI=1)
+#define MAX77650_GPIO_FALLING MAX77650_INT_GLBL_GPI_F   //edge: GPI falling
+#define MAX77650_GPIO_RISING MAX77650_INT_GLBL_GPI_R    //edge: GPI rising
+
+boolean MAX77650_gpio_mode(byte); //Configures the GPIO in one write, combine MAX77650_GPIO_* (e.g. MAX77650_GPIO_OUTPUT_PP | MAX77650_GPIO_HIGH)
+boolean MAX77650_gpio_write(boolean); //Sets the output level; one write, none if unchanged
+boolean MAX77650_gpio_toggle(void); //Inverts the output level; one write
+int MAX77650_gpio_read(void); //Returns the input level; -1=I2C error
+boolean MAX77650_gpio_onEdge(byte, void (*)(byte, unsigned long) = NULL); //Unmasks the edges (MAX77650_GPIO_RISING/FALLING) and sets the callback (edges, millis() of the IRQ); 0=masks both
+byte MAX77650_gpio_getEdges(void); //Returns and clears the edges seen since the last call
+
+
+//***** Energy estimator *****
+//Estimates the battery power from the rails: every rail has a load model (current when its load is active, current when 
+//idle, efficiency from the battery to the rail) and draws V * I / efficiency while enabled. The application reports the 
+//activity of the loads (MAX77650_energy_setActive), each report and each budget costs a constant time without I2C. 
+//MAX77650_energy_sync reads voltages and enables of the rails after they were changed (two burst reads). 
+//MAX77650_energy_measure measures battery voltage and discharge current with the AMUX (reader set with 
+//MAX77650_setAMUXReader); the ratio of measured to modelled power corrects the model, smoothed over the measurements. 
+//The budget reports the power now, the energy used per rail, the active share of every load and the remaining runtime.
+#define MAX77650_ENERGY_SBB0 0      //rail: SIMO channel 0
+#define MAX77650_ENERGY_SBB1 1      //rail: SIMO channel 1
+#define MAX77650_ENERGY_SBB2 2      //rail: SIMO channel 2
+#define MAX77650_ENERGY_LDO 3       //rail: LDO
+#define MAX77650_ENERGY_RAILS 4
+
+struct MAX77650_energy_budget {
+  unsigned long model_uW;                             //battery power of the rail models now
+  unsigned long measured_uW;                          //battery power of the last AMUX measurement; 0=none
+  unsigned long power_uW;                             //model power corrected by the measurements
+  unsigned long used_uWh;                             //battery energy used since MAX77650_energy_begin, corrected
+  unsigned long remaining_uWh;                        //battery energy left
+  unsigned long runtime_s;                            //time until the battery energy is used at power_uW
+  unsigned long rail_uWh[MAX77650_ENERGY_RAILS];      //battery energy per rail, model
+  byte duty[MAX77650_ENERGY_RAILS];                   //share of the time the load of a rail was active in %
+};
+
+boolean MAX77650_energy_begin(unsigned long); //Starts the estimator with the battery energy available in µWh and reads the rails
+void MAX77650_energy_setLoad(byte, unsigned long, unsigned long, byte = 85); //Sets the load model of a rail: current in µA when active and when idle, efficiency in %
+void MAX77650_energy_setActive(byte, boolean); //Reports whether the load of a rail is active
+boolean MAX77650_energy_sync(void); //Reads voltages and enables of the rails, e.g. after a change; Return Value: true=read
+boolean MAX77650_energy_measure(void); //Measures the battery power with the AMUX and corrects the model; Return Value: true=measured
+void MAX77650_energy_getBudget(MAX77650_energy_budget&); //Returns the power budget
+
+
+//***** Telemetry *****
+//Packs a status snapshot into a frame of MAX77650_TELEMETRY_FRAME bytes for links with little bandwidth: the charger and 
+//global status registers, the interrupts serviced since the previous frame (MAX77650_serviceInterrupts counts them) and 
+//up to MAX77650_TELEMETRY_CHANNELS AMUX channels (reader set with MAX77650_setAMUXReader). Frames are delta encoded: the 
+//status registers are sent as the bits changed and the AMUX readings as the difference to the previous frame, so a 
+//steady device sends frames of zeros that a run-length or byte-stuffing link shrinks to a few bytes. Every 
+//MAX77650_TELEMETRY_KEY frames, and when a difference does not fit its 12 bits, a key frame carries the values itself. 
+//The decoder applies the frames to its state; it drops delta frames after a lost or broken frame until the next key frame.
+//Frame: header (0b1010, key flag, sequence 0..7), STAT_CHG_A, STAT_CHG_B, STAT_GLBL, INT_GLBL and INT_CHG bits seen, 
+//interrupt services (saturating), 4 AMUX channels of 12 bits in two's complement (6 bytes), CRC-8 (polynomial 0x07).
+#define MAX77650_TELEMETRY_FRAME 14     //bytes of a frame
+#define MAX77650_TELEMETRY_KEY 16       //frames from one key frame to the next
+#define MAX77650_TELEMETRY_CHANNELS 4   //AMUX channels in a frame
+
+struct MAX77650_telemetry {
+  byte sequence;                                  //sequence number of the last frame
+  boolean key;                                    //the last frame was a key frame
+  boolean synced;                                 //the state holds the values of the last frame
+  byte STAT_CHG_A;                                //Charger Status Register A 0x02
+  byte STAT_CHG_B;                                //Charger Status Register B 0x03
+  byte STAT_GLBL;                                 //Global Status Register 0x05
+  byte INT_GLBL;                                  //global interrupts seen before the frame
+  byte INT_CHG;                                   //charger interrupts seen before the frame
+  byte irqs;                                      //interrupt services before the frame, 255=255 or more
+  int amux[MAX77650_TELEMETRY_CHANNELS];          //AMUX readings in ADC counts
+};
+
+boolean MAX77650_telemetry_begin(const byte* = NULL, byte = 0); //Sets the AMUX channels sampled for every frame (MAX77650_MUX_*, up to MAX77650_TELEMETRY_CHANNELS) and starts with a key frame
+boolean MAX77650_telemetry_frame(byte*); //Samples the status and encodes a frame of MAX77650_TELEMETRY_FRAME bytes; Return Value: true=frame encoded
+boolean MAX77650_telemetry_decode(const byte*, MAX77650_telemetry&); //Applies a frame to the state of a decoder (zero it to start); also for host tools; Return Value: true=state updated
+
+
+//***** Fault log *****
+//Keeps the fault and power events of the PMIC in a ring of MAX77650_FAULTLOG_LEN entries without allocation: the 
+//causes of the last power off or reset (ERCFLAG, read once by MAX77650_faultlog_begin since reading clears it), 
+//thermal alarms, junction temperature regulation, system voltage configuration errors and regulation, LDO dropout 
+//and CHGIN changes, each with the time the IRQ pin fired and a running sequence number. The events come from the 
+//interrupts serviced by MAX77650_serviceInterrupts. A full ring overwrites its oldest entry.
+//With a flush function the entries are written through in pages: MAX77650_faultlog_tick hands at most one page of 
+//new entries (never wrapping the ring) to the function, which stores it in flash and returns true, or false while the 
+//flash is busy. Few large writes keep flash wear and write stalls low; MAX77650_faultlog_flush also hands over a last 
+//incomplete page, e.g. before a shutdown. Entries overwritten before they were handed over are counted as lost.
+#ifndef MAX77650_FAULTLOG_LEN
+#define MAX77650_FAULTLOG_LEN 16      //entries of the ring (8 bytes each)
+#endif
+#define MAX77650_FAULT_RESET 0        //power off or reset before the start; data: ERCFLAG
+#define MAX77650_FAULT_TJAL1 1        //die temperature rose above TJAL1
+#define MAX77650_FAULT_TJAL2 2        //die temperature rose above TJAL2
+#define MAX77650_FAULT_TJ_REG 3       //junction temperature regulation changed; data: TJ_REG_STAT
+#define MAX77650_FAULT_SYS_CNFG 4     //system voltage configuration error
+#define MAX77650_FAULT_VSYS_MIN 5     //minimum system voltage regulation changed; data: VSYS_MIN_STAT
+#define MAX77650_FAULT_CHGIN 6        //CHGIN changed; data: CHGIN_DTLS
+#define MAX77650_FAULT_DROPOUT 7      //LDO entered dropout
+
+#define MAX77650_ERCFLAG_TOVLD 0b00000001       //thermal overload
+#define MAX77650_ERCFLAG_SYSOVLO 0b00000010     //system overvoltage lockout
+#define MAX77650_ERCFLAG_SYSUVLO 0b00000100     //system undervoltage lockout
+#define MAX77650_ERCFLAG_MRST 0b00001000        //manual reset timer expired (nEN held)
+#define MAX77650_ERCFLAG_SFT_OFF_F 0b00010000   //software off
+#define MAX77650_ERCFLAG_SFT_CRST_F 0b00100000  //software cold reset
+
+struct MAX77650_fault {
+  unsigned long time;   //millis() of the IRQ
+  uint16_t sequence;    //running number of the event
+  byte type;            //MAX77650_FAULT_*
+  byte data;
+};
+
+boolean MAX77650_faultlog_begin(boolean (*)(const MAX77650_fault*, byte) = NULL, byte = 8, uint16_t = 0); //Starts the log with the flush function, the entries per page and the sequence number of the first event (e.g. the last one stored + 1); logs ERCFLAG and unmasks the interrupts of the events
+void MAX77650_faultlog_tick(void); //Call from loop(); hands a complete page of new entries to the flush function
+boolean MAX77650_faultlog_flush(void); //Hands all new entries to the flush function; Return Value: true=all handed over
+byte MAX77650_faultlog_count(void); //Returns the number of entries in the ring
+boolean MAX77650_faultlog_get(byte, MAX77650_fault&); //Copies an entry, 0=oldest; Return Value: true=entry exists
+unsigned int MAX77650_faultlog_lost(void); //Returns the number of entries overwritten before they were handed to the flush function
+
+
+//***** Thermal throttling *****
+//Lowers the load of the PMIC in steps while its die is hot instead of running into its hard limits: level 1 when 
+//the die passes TJAL1 or the charger regulates its junction temperature (TJ_REG), level 2 when it passes TJAL2. Every 
+//level has its actions: a lower fast-charge current, dimmed LEDs and lower SBB target voltages; level 2 adds its 
+//actions to the ones of level 1. Levels rise at once from the interrupts; while throttled MAX77650_throttle_tick 
+//polls the alarms every MAX77650_THROTTLE_POLL_MS and steps one level down after the alarms of the level were clear 
+//for the hold time. No I2C while not throttled. The fields of all actions are written together through applyConfig, 
+//one burst write per block of neighbouring registers. Settings changed by the application while throttled are kept 
+//as the ones to restore. While the adaptive charge-current controller runs it owns CHG_CC: the fast-charge current of 
+//a level becomes a ceiling of the controller instead of being written, and is lifted again at level 0.
+#define MAX77650_THROTTLE_LEVELS 2        //levels above normal operation
+#define MAX77650_THROTTLE_POLL_MS 1000    //interval of polling the alarms while throttled
+
+struct MAX77650_throttle_level {
+  byte CHG_CC;          //fast-charge current code (MAX77650_CHG_CC_mA), used if lower than the setting; 0xFF=unchanged
+  byte brightness;      //LED brightness in % of the setting; 100=unchanged
+  byte TV_SBB[3];       //target voltage codes of SBB0..SBB2 (MAX77650_TV_SBBx_mV or voltageToCode), used if the voltage is lower than the setting; 0xFF=unchanged
+};
+
+boolean MAX77650_throttle_begin(const MAX77650_throttle_level*, unsigned long = 10000, void (*)(byte) = NULL); //Starts the controller with the actions of MAX77650_THROTTLE_LEVELS levels, the hold time in ms and a callback (new level); unmasks TJAL1_R, TJAL2_R and TJ_REG_I
+void MAX77650_throttle_end(void); //Restores the settings and stops the controller
+void MAX77650_throttle_tick(void); //Call from loop(); polls the alarms only while throttled
+byte MAX77650_throttle_getLevel(void); //Returns the level in effect, 0=normal operation
+
+
+//***** Transports *****
+//A transport moves bytes between the driver and the PMIC. read and write access len consecutive registers starting at 
+//the given register in one I2C transaction (auto-increment), a single register is a transfer of one byte. Transports 
+//return MAX77650_OK or a MAX77650_error; the codes 1..5 are the ones of Wire.endTransmission. submit starts a transfer without waiting for it; the default implementation runs it at once and calls 
+//its callback, transports of DMA or interrupt driven ports return before the transfer has finished.
+//A transfer interrupted by a reset of the µC mid-byte can leave the PMIC holding SDA low. recover frees the bus: the 
+//Wire transport stops the I2C port, clocks SCL until SDA is released (at most 9 clocks), generates a STOP and then starts the port again. 
+//The driver calls recover after a transfer timed out; with known pins the Wire transport also reports a timeout 
+//before a transaction when it finds SDA low, so a stuck bus costs a few ms instead of a hang in Wire and a watchdog reset.
+//Backends: MAX77650_wire_transport (Arduino Wire), MAX77650_linux_transport (Linux /dev/i2c-* through the I2C_RDWR 
+//ioctl) and MAX77650_sim_transport (register model of the PMIC for tests without hardware).
+#define MAX77650_BUS_PENDING -1   //status of a submitted transfer which has not finished yet
+
+enum MAX77650_error {
+  MAX77650_OK = 0,                  //transfer acknowledged
+  MAX77650_ERR_LENGTH = 1,          //transfer too long for the buffer of the I2C port; not repeated
+  MAX77650_ERR_NACK_ADDR = 2,       //PMIC did not acknowledge its address
+  MAX77650_ERR_NACK_DATA = 3,       //PMIC did not acknowledge a data byte
+  MAX77650_ERR_OTHER = 4,           //other bus error, e.g. I2C port not started
+  MAX77650_ERR_TIMEOUT = 5,         //transfer did not finish within the timeout of the I2C port
+  MAX77650_ERR_ARBITRATION = 6      //arbitration lost to another master; reported by the Linux transport only, Wire has no code for it (endTransmission 4 maps to MAX77650_ERR_OTHER)
+};
+
+struct MAX77650_transfer {
+  byte addr;                              //I2C address of the PMIC
+  byte reg;                               //first register
+  byte *data;                             //buffer of len bytes
+  byte len;
+  boolean write;                          //true=write data to the registers; false=read the registers into data
+  void (*done)(MAX77650_transfer&);       //called when the transfer has finished, may be NULL
+  void *context;                          //free for the caller
+  volatile int status;                    //MAX77650_BUS_PENDING while running, then the result of the transfer
+};
+
+class MAX77650_transport {
+  public:
+    virtual int begin(void); //Starts the I2C port; Return Value: 0=success
+    virtual int read(byte, byte, byte*, byte) = 0; //Reads len registers of the PMIC (address, first register, buffer, len); Return Value: 0=success
+    virtual int write(byte, byte, const byte*, byte) = 0; //Writes len registers of the PMIC (address, first register, data, len); Return Value: 0=success
+    virtual int submit(MAX77650_transfer&); //Starts a transfer; Return Value: 0=started, the callback reports the result
+    virtual int recover(void); //Frees a stuck bus; Return Value: MAX77650_OK=bus free; the default implementation cannot recover
+};
+
+#ifdef ARDUINO
+class MAX77650_wire_transport : public MAX77650_transport {
+  public:
+    MAX77650_wire_transport(TwoWire& = Wire, int = -1, int = -1); //I2C port of the host µC and its SDA and SCL pins (-1=unknown, recovery restarts the port only)
+    int begin(void);
+    int read(byte, byte, byte*, byte);
+    int write(byte, byte, const byte*, byte);
+    int recover(void);
+    TwoWire& getWire(void) const;
+  private:
+    TwoWire *_wire;
+    int _sda;
+    int _scl;
+    int idle(void);
+};
+#endif
+
+#if defined(__linux__) && !defined(ARDUINO)
+class MAX77650_linux_transport : public MAX77650_transport {
+  public:
+    MAX77650_linux_transport(const char* = MAX77650_I2C_device); //I2C adapter, e.g. "/dev/i2c-1"
+    ~MAX77650_linux_transport();
+    int begin(void); //Opens the adapter
+    void end(void); //Closes the adapter
+    int read(byte, byte, byte*, byte);
+    int write(byte, byte, const byte*, byte);
+    int recover(void); //Reopens the adapter; the kernel driver of the adapter recovers the bus
+  private:
+    const char *_device;
+    int _fd;
+};
+#endif
+
+#define MAX77650_SIM_REGS 0x47    //registers 0x00..0x46
+
+class MAX77650_sim_transport : public MAX77650_transport {
+  public:
+    MAX77650_sim_transport(byte = MAX77650_ADDR, byte = MAX77650_CID); //I2C address and CID of the simulated PMIC
+    int read(byte, byte, byte*, byte); //Interrupt registers are cleared by reading
+    int write(byte, byte, const byte*, byte); //Read-only bits are kept; SFT_RST resets the PMIC
+    int recover(void); //Always succeeds
+    void reset(void); //Loads the reset values
+    byte peek(byte) const; //Returns a register without side effects
+    void poke(byte, byte); //Sets a register including read-only bits, e.g. status and interrupt flags
+    unsigned long transactions;   //I2C transactions addressed to the PMIC
+    unsigned long bytes;          //data bytes transferred
+  private:
+    byte _addr;
+    byte _cid;
+    byte _reg[MAX77650_SIM_REGS];
+};
+
+
+//***** Trace recorder *****
+//A trace set on a MAX77650 object (setTrace) records every I2C transfer of it, including those of the MAX77650_* 
+//functions, into a ring buffer; when the buffer is full the oldest records are dropped. read drains complete records 
+//for sending to a host, where extras/MAX77650_trace_replay.cpp replays them into MAX77650_sim_transport.
+//A record is 6..77 bytes (3 header bytes, 1..5 bytes per LEB128 field, 1..64 data bytes):
+//  flags     bit 7: write, bit 6: failed, bits 5..0: number of data bytes - 1 (1..64)
+//  address   I2C address of the PMIC
+//  register  first register
+//  delta     µs since the start of the previous record, LEB128 (7 bits per byte, bit 7 set: more bytes follow)
+//  duration  µs the transfer took including its repetitions, LEB128
+//  data      the bytes written or read; a failed transfer has one byte instead: its MAX77650_error
+#ifndef MAX77650_TRACE_LEN
+#define MAX77650_TRACE_LEN 256    //bytes of the ring buffer of a trace
+#endif
+#define MAX77650_TRACE_WRITE 0b10000000   //flags: write transfer
+#define MAX77650_TRACE_FAILED 0b01000000  //flags: transfer failed
+#define MAX77650_TRACE_MAX_DATA 64        //data bytes a record holds at most
+
+struct MAX77650_trace_record {
+  byte addr;                  //I2C address of the PMIC
+  byte reg;                   //first register
+  byte len;                   //registers transferred
+  boolean write;
+  byte status;                //MAX77650_OK or the MAX77650_error of a failed transfer
+  unsigned long delta_us;     //µs since the start of the previous transfer
+  unsigned long duration_us;  //µs the transfer took
+  const byte *data;           //len bytes written or read; NULL if failed
+};
+
+unsigned int MAX77650_trace_decode(const byte*, unsigned int, MAX77650_trace_record&); //Decodes the record at the start of a buffer; Return Value: its size in bytes; 0=incomplete
+
+class MAX77650_trace {
+  public:
+    MAX77650_trace(); //Empty trace
+    void record(byte, byte, const byte*, byte, boolean, int, unsigned long, unsigned long); //Adds a transfer: address, register, data, length, write, result, start and duration in µs
+    unsigned int available(void) const; //Returns the bytes of the recorded records
+    unsigned int read(byte*, unsigned int); //Moves the oldest complete records into a buffer; Return Value: bytes copied
+    void clear(void); //Drops all records
+    unsigned long records;      //transfers recorded
+    unsigned long dropped;      //records dropped because the buffer was full
+  private:
+    byte _buf[MAX77650_TRACE_LEN];
+    unsigned int _tail;         //oldest record
+    unsigned int _used;         //bytes in the buffer
+    unsigned long _last_us;     //start of the previous transfer
+    unsigned int size(unsigned int) const;
+};
+
+
+//***** Latency histograms *****
+//With MAX77650_LATENCY_HISTOGRAMS the library records the duration of its operations per class into histograms of 
+//log2 buckets: bucket 0 counts durations below 2µs, bucket i durations of 2^i..2^(i+1)-1 µs, the last bucket all 
+//longer ones. Memory is fixed, recording costs two micros() calls and a few instructions. Classes: I2C reads and 
+//writes (every transfer including its repetitions), read-modify-writes of fields (setField and the MAX77650_set* 
+//functions), MAX77650_serviceInterrupts and AMUX measurements (per channel including the settling time).
+//Without MAX77650_LATENCY_HISTOGRAMS nothing is recorded and the histograms stay empty.
+#define MAX77650_LAT_READ 0       //I2C read transfers
+#define MAX77650_LAT_WRITE 1      //I2C write transfers
+#define MAX77650_LAT_RMW 2        //read-modify-writes of fields
+#define MAX77650_LAT_IRQ 3        //interrupt service
+#define MAX77650_LAT_AMUX 4       //AMUX measurements
+#define MAX77650_LAT_CLASSES 5
+#define MAX77650_HIST_BUCKETS 16  //last bucket: 32.768ms and longer
+
+struct MAX77650_histogram {
+  unsigned long count;                      //operations recorded
+  unsigned long max_us;                     //longest operation
+  unsigned long total_us;                   //sum of the durations, for the mean
+  uint16_t bucket[MAX77650_HIST_BUCKETS];   //operations per bucket, saturating at 65535
+};
+
+const MAX77650_histogram& MAX77650_getHistogram(byte); //Returns the histogram of a class (MAX77650_LAT_*)
+unsigned long MAX77650_getPercentile_us(byte, byte); //Returns the upper bound in µs of the bucket holding the given percentile of a class; 0=no operations
+void MAX77650_clearHistograms(void); //Clears all histograms
+
+
+//***** Log *****
+//The library logs events as an entry of message ID, level, time and two arguments into a ring of MAX77650_LOG_LEN 
+//entries. The text is formatted only when the application takes the entries (MAX77650_log_print or MAX77650_log_read 
+//with MAX77650_log_format), a message in a hot path costs the copy of an entry and no time on a serial port. Messages 
+//above MAX77650_LOG_LEVEL are removed by the preprocessor; with level 0 the library contains no logging code and 
+//the ring stays empty. A full ring keeps its entries, the first errors, and counts the new ones as dropped.
+#define MAX77650_LOG_ERROR 1    //level: operation failed
+#define MAX77650_LOG_WARN 2     //level: failure repaired by the library
+#define MAX77650_LOG_INFO 3     //level: change of state
+#define MAX77650_LOG_DEBUG 4    //level: details of normal operation
+#define MAX77650_LOG_LEN 32     //entries of the ring
+
+#define MAX77650_MSG_INIT 0             //info: driver started (I2C port, address)
+#define MAX77650_MSG_NO_PMIC 1          //error: PMIC not found (address, error)
+#define MAX77650_MSG_BUS_ERROR 2        //error: transfer failed after its repetitions (register, error)
+#define MAX77650_MSG_BUS_RECOVERED 3    //warning: stuck bus freed (register, error)
+#define MAX77650_MSG_BUS_RETRY 4        //debug: transfer repeated (register, attempt)
+#define MAX77650_MSG_SCRUB_REPAIR 5     //warning: register repaired from the shadow (register, value found)
+#define MAX77650_MSG_IRQ 6              //debug: interrupts serviced (INT_GLBL, INT_CHG)
+#define MAX77650_MSG_JEITA_ZONE 7       //info: charger profile of a temperature zone applied (zone, temperature in 0.1°C)
+#define MAX77650_MSG_SHUTDOWN_FAILED 8  //error: shutdown sequence aborted (dry run, duration in µs)
+#define MAX77650_MSG_THROTTLE 9         //info: thermal throttling level changed (new level, previous level)
+#define MAX77650_MSG_SHUTDOWN_DROPPED 10  //error: scheduler not flushed at shutdown, pending requests dropped (requests, error)
+#define MAX77650_MSG_COUNT 11
+
+struct MAX77650_log_entry {
+  unsigned long time;     //millis() of the event
+  byte level;             //MAX77650_LOG_*
+  byte id;                //MAX77650_MSG_*
+  long arg[2];            //arguments of the message
+};
+
+boolean MAX77650_log_read(MAX77650_log_entry&); //Takes the oldest entry from the ring; Return Value: true=entry taken
+const char* MAX77650_log_format(byte); //Returns the printf format of a message ID, with the two arguments as long
+unsigned int MAX77650_log_dropped(void); //Returns and clears the number of entries dropped on a full ring
+#ifdef ARDUINO
+void MAX77650_log_print(Print&); //Formats and prints all entries of the ring, e.g. MAX77650_log_print(Serial)
+#endif
+
+
+//***** Driver objects *****
+//A MAX77650 object drives one PMIC at its address (0x48 or 0x40) through a transport, so several PMICs can be driven 
+//by one host. Every object keeps a shadow of the configuration registers (INT_M_GLBL, INT_M_CHG, CNFG_GLBL, CNFG_GPIO and the 
+//CNFG_CHG, CNFG_SBB, CNFG_LDO and CNFG_LED blocks) holding the last value written to or first read from each register: 
+//updateRegister and setField change a cached register with one write and no read, and skip the write (and its 
+//verification) when the register already holds the value. The MAX77650_set* functions use setField. writeRegister 
+//always writes. Interrupt and status registers are never cached. A write of SFT_RST clears the shadow, a failed write the registers written.
+//A failed transfer is repeated up to MAX77650_I2C_retries times with doubling waits starting at MAX77650_I2C_backoff_us, 
+//but no repetition is started which would end after MAX77650_I2C_timeout_us: together with the timeout of the I2C 
+//port every call has a bounded duration. The error of the last failed transfer is kept (getLastError). A timeout 
+//triggers the recovery of the transport before the next repetition. The watchdog function, if set, is called before 
+//every repetition, so a long recovery does not reset the µC while the driver makes progress within its bound.
+//The MAX77650_* functions drive the object MAX77650_PMIC (MAX77650_ADDR on MAX77650_I2C_port or MAX77650_I2C_device); 
+//the interrupt service, the charge-current controller, the AMUX functions and the JEITA supervisor work on it.
+#define MAX77650_SHADOW_LEN 29    //number of cached registers
+
+struct MAX77650_field {
+  byte reg;     //register address
+  byte mask;    //mask of the value, right aligned
+  byte shift;   //position of the lowest bit of the value in the register
+};
+
+int MAX77650_register_index(byte); //Returns the position of a configuration register in the shadow and in MAX77650_config; -1=not cached
+byte MAX77650_register_address(byte); //Returns the address of the configuration register at a position
+
+//A configuration holds the desired values of register fields; registers and bits which are not configured keep their 
+//value. applyConfig reads the live registers once in burst reads, compares them with the configuration and writes only 
+//the registers which differ; neighbouring ones are coalesced into one burst write. A configuration matching the 
+//reset/OTP defaults costs no write at all, so the cold-boot configuration takes a few transactions only.
+#define MAX77650_CONFIG_GAP 1   //unchanged registers a burst write spans instead of starting a new one
+
+struct MAX77650_config {
+  byte value[MAX77650_SHADOW_LEN];  //desired register values
+  byte mask[MAX77650_SHADOW_LEN];   //configured bits
+  
+  MAX77650_config(); //Configures nothing
+  MAX77650_config& set(const MAX77650_field&, byte); //Configures a field
+  MAX77650_config& set(const MAX77650_charger_profile&); //Configures CNFG_CHG_A..I
+  MAX77650_config& setRegister(byte, byte, byte = 0xFF); //Configures the bits (mask) of a register
+  int get(const MAX77650_field&) const; //Returns the configured value of a field; -1=not configured
+};
+
+//A snapshot is the configuration image of the PMIC protected by a CRC. Kept in retention RAM or flash across an MCU 
+//reset while the PMIC stays powered, restoreSnapshot checks it against the PMIC and writes only the registers which 
+//differ (see applyConfig): a warm boot costs a few burst reads instead of the full configuration.
+#define MAX77650_SNAPSHOT_VERSION 1   //layout of MAX77650_snapshot; snapshots of another layout are invalid
+
+struct MAX77650_snapshot {
+  byte version;                     //MAX77650_SNAPSHOT_VERSION
+  byte cid;                         //CID of the PMIC the snapshot was taken from
+  byte image[MAX77650_SHADOW_LEN];  //configuration registers in the order of the shadow
+  uint16_t crc;                     //CRC-16/CCITT of version, cid and image (not of the padding in front of it)
+  
+  boolean valid(void) const; //Returns whether layout and CRC are correct
+};
+
+//The scrubber detects registers changed behind the back of the driver, e.g. reset by ESD or a brown-out: every call of 
+//scrub burst-reads the next cached registers round-robin, at most the budget per call, and compares the settings with 
+//the shadow. Diverged registers are rewritten from the shadow and reported to the callback. Per call the bus cost is 
+//bounded by one burst read per register block touched plus one write per repaired register, both within the budget.
+#ifndef MAX77650_SCRUB_BUDGET
+#define MAX77650_SCRUB_BUDGET 8   //default number of registers compared per call of scrub
 #endif
 
+struct MAX77650_scrub_stats {
+  unsigned long passes;       //complete passes over the shadow
+  unsigned long registers;    //registers compared
+  unsigned long mismatches;   //registers found diverged from the shadow
+  unsigned long repairs;      //diverged registers rewritten successfully
+  unsigned long errors;       //I2C errors while scrubbing
+};
+
+struct MAX77650_bus_stats {
+  unsigned long transfers;    //I2C transfers to the PMIC
+  unsigned long retries;      //repetitions of failed transfers
+  unsigned long errors;       //transfers failed after all repetitions
+  unsigned long worst_us;     //longest transfer including its repetitions
+  unsigned long recoveries;   //bus recoveries after timeouts
+};
+
+//Tasks of an RTOS may share a MAX77650 object when a lock is set. The registers form groups with locks of their own; a 
+//read-modify-write (updateRegister, setField) holds the lock of its group from the read to the write, so two tasks changing 
+//CNFG_GLBL or CNFG_CHG_B cannot lose each other's update, while tasks working on different groups proceed in parallel. 
+//Every transfer holds the lock of the bus. applyConfig, takeSnapshot and restoreSnapshot hold all groups. Locks are taken 
+//in ascending group order, the bus last; they must be recursive (e.g. FreeRTOS recursive mutexes). Without a lock the 
+//object must be used by one task only. Do not call the driver from an interrupt handler.
+#define MAX77650_GROUP_GLOBAL 0     //INT_M_GLBL, INT_M_CHG, CNFG_GLBL, CNFG_GPIO
+#define MAX77650_GROUP_CHARGER 1    //CNFG_CHG_A..I
+#define MAX77650_GROUP_SBB 2        //CNFG_SBB_TOP..CNFG_SBB2_B, CNFG_LDO_A..B
+#define MAX77650_GROUP_LED 3        //CNFG_LED0_A..CNFG_LED_TOP
+#define MAX77650_GROUP_BUS 4        //the I2C transfers; registers which are not cached (interrupts, status, CID)
+#define MAX77650_LOCKS 5            //number of locks
+
+class MAX77650_lock {
+  public:
+    virtual void lock(byte) = 0;    //Takes the lock of a group; recursive
+    virtual void unlock(byte) = 0;  //Releases the lock of a group
+};
+
+byte MAX77650_register_group(byte); //Returns the lock group of a register (MAX77650_GROUP_*)
+
+class MAX77650;
+typedef void (*MAX77650_scrub_callback)(MAX77650&, byte, byte, byte); //PMIC, register, value of the shadow, value found
+
+class MAX77650 {
+  public:
+    MAX77650(MAX77650_transport&, byte = MAX77650_ADDR); //Transport and I2C address of the PMIC
+    boolean begin(void); //Starts the transport, clears the shadow and detects the part (DIDM) and CID; Return Value: true=PMIC acknowledged
+    byte getAddress(void) const; //Returns the I2C address of the PMIC
+    byte getPart(void) const; //Returns the part detected by begin without I2C (MAX77650_PART_*); MAX77650_PART_UNKNOWN=not detected
+    int getCID(void) const; //Returns the CID register read by begin without I2C; -1=not read
+    unsigned int codeToVoltage(byte, byte) const; //Converts a target voltage code of the register (CNFG_SBBx_A or CNFG_LDO_A) into mV with the tables of the part
+    byte voltageToCode(byte, unsigned int) const; //Converts mV into the target voltage code of the register with the tables of the part; out of range values are clamped
+    MAX77650_transport& getTransport(void) const; //Returns the transport of the PMIC
+    void setTransport(MAX77650_transport&); //Moves the PMIC to another transport and clears the shadow
+    void setRetries(byte, unsigned int, unsigned long); //Sets repetitions, first backoff in µs and bound of a transfer in µs
+    MAX77650_error getLastError(void) const; //Returns the error of the last failed transfer
+    const MAX77650_bus_stats& getBusStats(void) const; //Returns the counters of the transfers
+    void setWatchdog(void (*)(void)); //Sets the function feeding the watchdog of the µC during repetitions and recoveries
+    void setLock(MAX77650_lock*); //Sets the lock of the register groups shared by RTOS tasks; NULL=single task
+    MAX77650_lock* getLock(void) const; //Returns the lock of the register groups; NULL=none
+    void setTrace(MAX77650_trace*); //Records the transfers into the trace; NULL=stop recording
+
+    int readRegister(byte); //Reads a register; Return Value: register value; -1=I2C error (see getLastError)
+    byte writeRegister(byte, byte); //Writes a register in one transaction; Return Value: MAX77650_OK or a MAX77650_error
+    boolean readBurst(byte, byte*, byte); //Reads consecutive registers in one I2C transaction; Return Value: true=all bytes received
+    boolean writeBurst(byte, const byte*, byte); //Writes consecutive registers in one I2C transaction; Return Value: true=transmission acknowledged
+    boolean updateRegister(byte, byte, byte); //Replaces the bits (mask) of a register by value; a cached register costs one write or none if unchanged
+    int getField(const MAX77650_field&); //Reads a field; Return Value: field value; -1=I2C error
+    boolean setField(const MAX77650_field&, byte); //Sets a field unless the shadow holds the value; verified by reading it back (MAX77650_VERIFY_WRITES)
+    boolean applyChargerProfile(const MAX77650_charger_profile&); //Writes CNFG_CHG_A..I in one burst and verifies them with one burst read
+    boolean getChargerProfile(MAX77650_charger_profile&); //Reads CNFG_CHG_A..I in one burst into the profile
+    int applyConfig(const MAX77650_config&); //Writes the registers differing from the configuration; Return Value: number of burst writes; -1=I2C error or verification failed
+    boolean takeSnapshot(MAX77650_snapshot&); //Reads the configuration registers in burst reads into the snapshot
+    int restoreSnapshot(const MAX77650_snapshot&); //Writes the registers differing from a valid snapshot of this PMIC; Return Value: number of burst writes; -1=invalid snapshot, other PMIC or I2C error
+
+    void setScrubber(byte, MAX77650_scrub_callback = NULL); //Sets the budget (registers per call) and the report callback of the scrubber
+    int scrub(void); //Call periodically; compares the next registers with the shadow and repairs them; Return Value: repaired registers; -1=I2C error
+    const MAX77650_scrub_stats& getScrubStats(void) const; //Returns the counters of the scrubber
+
+    int getShadow(byte) const; //Returns the cached value of a register; -1=not cached
+    void invalidateShadow(void); //Forgets all cached values, e.g. after the PMIC was reset by other means
+
+  private:
+    MAX77650_transport *_bus;
+    byte _addr;
+    byte _part;                                   //DIDM read by begin
+    int _cid;                                     //CID register read by begin
+    byte _retries;
+    unsigned int _backoff_us;
+    unsigned long _timeout_us;
+    MAX77650_error _last_error;
+    MAX77650_bus_stats _bus_stats;
+    void (*_watchdog)(void);
+    MAX77650_lock *_lock;
+    MAX77650_trace *_trace;
+    byte _shadow[MAX77650_SHADOW_LEN];
+    byte _cached[MAX77650_SHADOW_LEN];  //one byte per shadow entry: groups never share a byte
+    byte _scrub_pos;                              //next shadow entry to scrub
+    byte _scrub_budget;
+    MAX77650_scrub_callback _scrub_report;
+    MAX77650_scrub_stats _scrub_stats;
+    void cache(byte, byte, boolean);
+    boolean cached(byte) const;
+    void forget(byte, byte);
+    int transfer(boolean, byte, byte*, byte);
+};
+
+extern MAX77650 MAX77650_PMIC; //PMIC of the MAX77650_* functions
+
+int MAX77650_applyConfig(const MAX77650_config&); //Writes the registers of MAX77650_PMIC differing from the configuration; Return Value: number of burst writes; -1=error
+boolean MAX77650_takeSnapshot(MAX77650_snapshot&); //Reads the configuration of MAX77650_PMIC into the snapshot
+MAX77650_error MAX77650_getLastError(void); //Returns the error of the last failed transfer of MAX77650_PMIC
+byte MAX77650_getPart(void); //Returns the part of MAX77650_PMIC detected by MAX77650_init (MAX77650_PART_*)
+int MAX77650_scrub(void); //Scrubs the registers of MAX77650_PMIC; Return Value: repaired registers; -1=I2C error
+int MAX77650_restoreSnapshot(const MAX77650_snapshot&); //Restores the differences of a snapshot to MAX77650_PMIC; Return Value: number of burst writes; -1=error
+
+//Field descriptors of the register fields; the names follow the MAX77650_get*/MAX77650_set* functions
+//STAT_GLBL
+constexpr MAX77650_field MAX77650_FIELD_DIDM = {MAX77650_STAT_GLBL_ADDR, 0b00000011, 6};
+constexpr MAX77650_field MAX77650_FIELD_LDO_DropoutDetector = {MAX77650_STAT_GLBL_ADDR, 0b00000001, 5};
+constexpr MAX77650_field MAX77650_FIELD_ThermalAlarm1 = {MAX77650_STAT_GLBL_ADDR, 0b00000001, 3};
+constexpr MAX77650_field MAX77650_FIELD_ThermalAlarm2 = {MAX77650_STAT_GLBL_ADDR, 0b00000001, 4};
+constexpr MAX77650_field MAX77650_FIELD_DebounceStatusnEN0 = {MAX77650_STAT_GLBL_ADDR, 0b00000001, 2};
+constexpr MAX77650_field MAX77650_FIELD_DebounceStatusPWR_HLD = {MAX77650_STAT_GLBL_ADDR, 0b00000001, 1};
+
+//ERCFLAG
+constexpr MAX77650_field MAX77650_FIELD_ERCFLAG = {MAX77650_ERCFLAG_ADDR, 0b11111111, 0};
+
+//STAT_CHG_A
+constexpr MAX77650_field MAX77650_FIELD_VCHGIN_MIN_STAT = {MAX77650_STAT_CHG_A_ADDR, 0b00000001, 6};
+constexpr MAX77650_field MAX77650_FIELD_ICHGIN_LIM_STAT = {MAX77650_STAT_CHG_A_ADDR, 0b00000001, 5};
+constexpr MAX77650_field MAX77650_FIELD_VSYS_MIN_STAT = {MAX77650_STAT_CHG_A_ADDR, 0b00000001, 4};
+constexpr MAX77650_field MAX77650_FIELD_TJ_REG_STAT = {MAX77650_STAT_CHG_A_ADDR, 0b00000001, 3};
+constexpr MAX77650_field MAX77650_FIELD_THM_DTLS = {MAX77650_STAT_CHG_A_ADDR, 0b00000111, 0};
+
+//STAT_CHG_B
+constexpr MAX77650_field MAX77650_FIELD_CHG_DTLS = {MAX77650_STAT_CHG_B_ADDR, 0b00001111, 4};
+constexpr MAX77650_field MAX77650_FIELD_CHGIN_DTLS = {MAX77650_STAT_CHG_B_ADDR, 0b00000011, 2};
+constexpr MAX77650_field MAX77650_FIELD_CHG = {MAX77650_STAT_CHG_B_ADDR, 0b00000001, 1};
+constexpr MAX77650_field MAX77650_FIELD_TIME_SUS = {MAX77650_STAT_CHG_B_ADDR, 0b00000001, 0};
+
+//CNFG_LED0_A
+constexpr MAX77650_field MAX77650_FIELD_LED_FS0 = {MAX77650_CNFG_LED0_A_ADDR, 0b00000011, 6};
+constexpr MAX77650_field MAX77650_FIELD_INV_LED0 = {MAX77650_CNFG_LED0_A_ADDR, 0b00000001, 5};
+constexpr MAX77650_field MAX77650_FIELD_BRT_LED0 = {MAX77650_CNFG_LED0_A_ADDR, 0b00011111, 0};
+
+//CNFG_LED0_B
+constexpr MAX77650_field MAX77650_FIELD_P_LED0 = {MAX77650_CNFG_LED0_B_ADDR, 0b00001111, 4};
+constexpr MAX77650_field MAX77650_FIELD_D_LED0 = {MAX77650_CNFG_LED0_B_ADDR, 0b00001111, 0};
+
+//CNFG_LED1_A
+constexpr MAX77650_field MAX77650_FIELD_LED_FS1 = {MAX77650_CNFG_LED1_A_ADDR, 0b00000011, 6};
+constexpr MAX77650_field MAX77650_FIELD_INV_LED1 = {MAX77650_CNFG_LED1_A_ADDR, 0b00000001, 5};
+constexpr MAX77650_field MAX77650_FIELD_BRT_LED1 = {MAX77650_CNFG_LED1_A_ADDR, 0b00011111, 0};
+
+//CNFG_LED1_B
+constexpr MAX77650_field MAX77650_FIELD_P_LED1 = {MAX77650_CNFG_LED1_B_ADDR, 0b00001111, 4};
+constexpr MAX77650_field MAX77650_FIELD_D_LED1 = {MAX77650_CNFG_LED1_B_ADDR, 0b00001111, 0};
+
+//CNFG_LED2_A
+constexpr MAX77650_field MAX77650_FIELD_LED_FS2 = {MAX77650_CNFG_LED2_A_ADDR, 0b00000011, 6};
+constexpr MAX77650_field MAX77650_FIELD_INV_LED2 = {MAX77650_CNFG_LED2_A_ADDR, 0b00000001, 5};
+constexpr MAX77650_field MAX77650_FIELD_BRT_LED2 = {MAX77650_CNFG_LED2_A_ADDR, 0b00011111, 0};
+
+//CNFG_LED2_B
+constexpr MAX77650_field MAX77650_FIELD_P_LED2 = {MAX77650_CNFG_LED2_B_ADDR, 0b00001111, 4};
+constexpr MAX77650_field MAX77650_FIELD_D_LED2 = {MAX77650_CNFG_LED2_B_ADDR, 0b00001111, 0};
+
+//CNFG_GLBL
+constexpr MAX77650_field MAX77650_FIELD_BOK = {MAX77650_CNFG_GLBL_ADDR, 0b00000001, 6};
+constexpr MAX77650_field MAX77650_FIELD_SBIA_LPM = {MAX77650_CNFG_GLBL_ADDR, 0b00000001, 5};
+constexpr MAX77650_field MAX77650_FIELD_SBIA_EN = {MAX77650_CNFG_GLBL_ADDR, 0b00000001, 4};
+constexpr MAX77650_field MAX77650_FIELD_nEN_MODE = {MAX77650_CNFG_GLBL_ADDR, 0b00000001, 3};
+constexpr MAX77650_field MAX77650_FIELD_DBEN_nEN = {MAX77650_CNFG_GLBL_ADDR, 0b00000001, 2};
+constexpr MAX77650_field MAX77650_FIELD_SFT_RST = {MAX77650_CNFG_GLBL_ADDR, 0b00000011, 0};
+
+//INT_GLBL
+constexpr MAX77650_field MAX77650_FIELD_INT_GLBL = {MAX77650_INT_GLBL_ADDR, 0b11111111, 0};
+
+//INTM_GLBL
+constexpr MAX77650_field MAX77650_FIELD_INT_M_GLBL = {MAX77650_INTM_GLBL_ADDR, 0b01111111, 0};
+
+//CNFG_GPIO
+constexpr MAX77650_field MAX77650_FIELD_DBEN_GPI = {MAX77650_CNFG_GPIO_ADDR, 0b00000001, 4};
+constexpr MAX77650_field MAX77650_FIELD_DO = {MAX77650_CNFG_GPIO_ADDR, 0b00000001, 3};
+constexpr MAX77650_field MAX77650_FIELD_DRV = {MAX77650_CNFG_GPIO_ADDR, 0b00000001, 2};
+constexpr MAX77650_field MAX77650_FIELD_DI = {MAX77650_CNFG_GPIO_ADDR, 0b00000001, 1};
+constexpr MAX77650_field MAX77650_FIELD_DIR = {MAX77650_CNFG_GPIO_ADDR, 0b00000001, 0};
+
+//INT_CHG
+constexpr MAX77650_field MAX77650_FIELD_INT_CHG = {MAX77650_INT_CHG_ADDR, 0b11111111, 0};
+
+//INT_M_CHG
+constexpr MAX77650_field MAX77650_FIELD_INT_M_CHG = {MAX77650_INT_M_CHG_ADDR, 0b01111111, 0};
+
+//CNFG_CHG_A
+constexpr MAX77650_field MAX77650_FIELD_THM_HOT = {MAX77650_CNFG_CHG_A_ADDR, 0b00000011, 6};
+constexpr MAX77650_field MAX77650_FIELD_THM_WARM = {MAX77650_CNFG_CHG_A_ADDR, 0b00000011, 4};
+constexpr MAX77650_field MAX77650_FIELD_THM_COOL = {MAX77650_CNFG_CHG_A_ADDR, 0b00000011, 2};
+constexpr MAX77650_field MAX77650_FIELD_THM_COLD = {MAX77650_CNFG_CHG_A_ADDR, 0b00000011, 0};
+
+//CNFG_CHG_B
+constexpr MAX77650_field MAX77650_FIELD_VCHGIN_MIN = {MAX77650_CNFG_CHG_B_ADDR, 0b00000111, 5};
+constexpr MAX77650_field MAX77650_FIELD_ICHGIN_LIM = {MAX77650_CNFG_CHG_B_ADDR, 0b00000111, 2};
+constexpr MAX77650_field MAX77650_FIELD_I_PQ = {MAX77650_CNFG_CHG_B_ADDR, 0b00000001, 1};
+constexpr MAX77650_field MAX77650_FIELD_CHG_EN = {MAX77650_CNFG_CHG_B_ADDR, 0b00000001, 0};
+
+//CNFG_CHG_C
+constexpr MAX77650_field MAX77650_FIELD_CHG_PQ = {MAX77650_CNFG_CHG_C_ADDR, 0b00000111, 5};
+constexpr MAX77650_field MAX77650_FIELD_I_TERM = {MAX77650_CNFG_CHG_C_ADDR, 0b00000011, 3};
+constexpr MAX77650_field MAX77650_FIELD_T_TOPOFF = {MAX77650_CNFG_CHG_C_ADDR, 0b00000111, 0};
+
+//CNFG_CHG_D
+constexpr MAX77650_field MAX77650_FIELD_TJ_REG = {MAX77650_CNFG_CHG_D_ADDR, 0b00000111, 5};
+constexpr MAX77650_field MAX77650_FIELD_VSYS_REG = {MAX77650_CNFG_CHG_D_ADDR, 0b00011111, 0};
+
+//CNFG_CHG_E
+constexpr MAX77650_field MAX77650_FIELD_CHG_CC = {MAX77650_CNFG_CHG_E_ADDR, 0b00111111, 2};
+constexpr MAX77650_field MAX77650_FIELD_T_FAST_CHG = {MAX77650_CNFG_CHG_E_ADDR, 0b00000011, 0};
+
+//CNFG_CHG_F
+constexpr MAX77650_field MAX77650_FIELD_CHG_CC_JEITA = {MAX77650_CNFG_CHG_F_ADDR, 0b00111111, 2};
+constexpr MAX77650_field MAX77650_FIELD_THM_EN = {MAX77650_CNFG_CHG_F_ADDR, 0b00000001, 1};
+
+//CNFG_CHG_G
+constexpr MAX77650_field MAX77650_FIELD_CHG_CV = {MAX77650_CNFG_CHG_G_ADDR, 0b00111111, 2};
+constexpr MAX77650_field MAX77650_FIELD_USBS = {MAX77650_CNFG_CHG_G_ADDR, 0b00000001, 1};
+
+//CNFG_CHG_H
+constexpr MAX77650_field MAX77650_FIELD_CHG_CV_JEITA = {MAX77650_CNFG_CHG_H_ADDR, 0b00111111, 2};
+
+//CNFG_CHG_I
+constexpr MAX77650_field MAX77650_FIELD_IMON_DISCHG_SCALE = {MAX77650_CNFG_CHG_I_ADDR, 0b00001111, 4};
+constexpr MAX77650_field MAX77650_FIELD_MUX_SEL = {MAX77650_CNFG_CHG_I_ADDR, 0b00001111, 0};
+
+//CNFG_LDO_A
+constexpr MAX77650_field MAX77650_FIELD_TV_LDO = {MAX77650_CNFG_LDO_A_ADDR, 0b01111111, 0};
+
+//CNFG_LDO_B
+constexpr MAX77650_field MAX77650_FIELD_ADE_LDO = {MAX77650_CNFG_LDO_B_ADDR, 0b00000001, 3};
+constexpr MAX77650_field MAX77650_FIELD_EN_LDO = {MAX77650_CNFG_LDO_B_ADDR, 0b00000111, 0};
+
+//CNFG_SBB_TOP
+constexpr MAX77650_field MAX77650_FIELD_MRT_OTP = {MAX77650_CNFG_SBB_TOP_ADDR, 0b00000001, 6};
+constexpr MAX77650_field MAX77650_FIELD_SBIA_LPM_DEF = {MAX77650_CNFG_SBB_TOP_ADDR, 0b00000001, 5};
+constexpr MAX77650_field MAX77650_FIELD_DBNC_nEN_DEF = {MAX77650_CNFG_SBB_TOP_ADDR, 0b00000001, 4};
+constexpr MAX77650_field MAX77650_FIELD_DRV_SBB = {MAX77650_CNFG_SBB_TOP_ADDR, 0b00000011, 0};
+
+//CNFG_SBB0_A
+constexpr MAX77650_field MAX77650_FIELD_IP_SBB0 = {MAX77650_CNFG_SBB0_A_ADDR, 0b00000011, 6};
+constexpr MAX77650_field MAX77650_FIELD_TV_SBB0 = {MAX77650_CNFG_SBB0_A_ADDR, 0b00111111, 0};
+
+//CNFG_SBB0_B
+constexpr MAX77650_field MAX77650_FIELD_ADE_SBB0 = {MAX77650_CNFG_SBB0_B_ADDR, 0b00000001, 3};
+constexpr MAX77650_field MAX77650_FIELD_EN_SBB0 = {MAX77650_CNFG_SBB0_B_ADDR, 0b00000111, 0};
+
+//CNFG_SBB1_A
+constexpr MAX77650_field MAX77650_FIELD_IP_SBB1 = {MAX77650_CNFG_SBB1_A_ADDR, 0b00000011, 6};
+constexpr MAX77650_field MAX77650_FIELD_TV_SBB1 = {MAX77650_CNFG_SBB1_A_ADDR, 0b00111111, 0};
+
+//CNFG_SBB1_B
+constexpr MAX77650_field MAX77650_FIELD_ADE_SBB1 = {MAX77650_CNFG_SBB1_B_ADDR, 0b00000001, 3};
+constexpr MAX77650_field MAX77650_FIELD_EN_SBB1 = {MAX77650_CNFG_SBB1_B_ADDR, 0b00000111, 0};
+
+//CNFG_SBB2_A
+constexpr MAX77650_field MAX77650_FIELD_IP_SBB2 = {MAX77650_CNFG_SBB2_A_ADDR, 0b00000011, 6};
+constexpr MAX77650_field MAX77650_FIELD_TV_SBB2 = {MAX77650_CNFG_SBB2_A_ADDR, 0b00111111, 0};
+
+//CNFG_SBB2_B
+constexpr MAX77650_field MAX77650_FIELD_ADE_SBB2 = {MAX77650_CNFG_SBB2_B_ADDR, 0b00000001, 3};
+constexpr MAX77650_field MAX77650_FIELD_EN_SBB2 = {MAX77650_CNFG_SBB2_B_ADDR, 0b00000111, 0};
+
+//CNFG_LED_TOP
+constexpr MAX77650_field MAX77650_FIELD_CLK_64_S = {MAX77650_CNFG_LED_TOP_ADDR, 0b00000001, 1};
+constexpr MAX77650_field MAX77650_FIELD_EN_LED_MSTR = {MAX77650_CNFG_LED_TOP_ADDR, 0b00000001, 0};
+
+//CID
+constexpr MAX77650_field MAX77650_FIELD_CID = {MAX77650_CID_ADDR, 0b00001111, 0};
+
+
+//***** Request scheduler *****
+//Writes of MAX77650_PMIC which need not happen at once (LED animation, trimming of rails or currents) are posted to a 
+//queue and written by MAX77650_scheduler_tick, one request per call in the order: requests past their deadline, then 
+//priority class, then earliest deadline. A request for a register with a request pending is merged into it, so only 
+//the latest value of a field is sent (e.g. BRT_LED0) and several fields of a register cost one write. Requests of 
+//class MAX77650_PRIO_CRITICAL (e.g. dropping a rail on a thermal alarm) bypass the queue and are written at once, 
+//their latency is one transfer within the bound of setRetries however many requests are queued; the bits they set 
+//are removed from pending requests, so no older value overwrites them later. A tick holds the lock group of the 
+//register from dequeuing a request through its write, so a critical write waits for a write in progress of its group.
+#ifndef MAX77650_SCHEDULER_LEN
+#define MAX77650_SCHEDULER_LEN 8    //requests (registers) the queue holds
+#endif
+#define MAX77650_PRIO_CRITICAL 0    //written at once
+#define MAX77650_PRIO_HIGH 1        //power states
+#define MAX77650_PRIO_NORMAL 2      //regulation, e.g. charge current
+#define MAX77650_PRIO_LOW 3         //cosmetic, e.g. LEDs
+
+struct MAX77650_scheduler_stats {
+  unsigned long posted;       //requests posted
+  unsigned long coalesced;    //requests merged into a pending request of the same register
+  unsigned long executed;     //register writes of the queue
+  unsigned long late;         //writes after their deadline
+  unsigned long rejected;     //requests not posted because the queue was full
+  unsigned long errors;       //failed writes, the request stays queued
+};
+
+boolean MAX77650_post(const MAX77650_field&, byte, byte = MAX77650_PRIO_NORMAL, unsigned int = 0); //Posts a field write with priority class and deadline in ms from now (0=none); Return Value: true=queued or, for MAX77650_PRIO_CRITICAL, written
+boolean MAX77650_postRegister(byte, byte, byte, byte = MAX77650_PRIO_NORMAL, unsigned int = 0); //Posts a write of the bits (mask) of a register with priority class and deadline in ms from now (0=none)
+int MAX77650_scheduler_tick(byte = 1); //Call from loop(); writes up to the given number of requests; Return Value: requests written; -1=I2C error
+boolean MAX77650_scheduler_flush(void); //Writes all pending requests; Return Value: true=queue empty
+byte MAX77650_scheduler_pending(void); //Returns the number of pending requests
+const MAX77650_scheduler_stats& MAX77650_scheduler_getStats(void); //Returns the counters of the scheduler
+
+
+//***** Shutdown sequencer *****
+//Powers the system down in a fixed order with a bounded number of transactions: pending requests of the scheduler are 
+//written, then the rails of every stage are switched off (EN_x = off irrespective of the flexible power sequencer, LEDs by 
+//EN_LED_MSTR), then PWR_HLD is released and/or the PMIC is switched off by software (SFT_RST). Within a stage LEDs go 
+//first, then the LDO, then the SIMO channels of the stage in one burst. The values come from the shadow (registers not 
+//cached are read once), nothing is read back. A dry run writes the same transactions with the registers unchanged and 
+//neither releases PWR_HLD nor switches off, e.g. to measure the duration at start; the longest duration is kept.
+#define MAX77650_RAIL_SBB0 0b00000001     //SIMO channel 0
+#define MAX77650_RAIL_SBB1 0b00000010     //SIMO channel 1
+#define MAX77650_RAIL_SBB2 0b00000100     //SIMO channel 2
+#define MAX77650_RAIL_LDO 0b00001000      //LDO
+#define MAX77650_RAIL_LEDS 0b00010000     //LED current sinks
+#define MAX77650_RAIL_ALL 0b00011111
+#define MAX77650_SHUTDOWN_STAGES 5        //stages of a sequence at most
+
+void MAX77650_shutdown_begin(int = -1, unsigned int = 0); //Sets the host pin driving PWR_HLD (-1=none) and drives it high to hold the power; the time in ms between the stages
+boolean MAX77650_shutdown_setSequence(const byte*, byte); //Sets the rails switched off per stage (MAX77650_RAIL_*), in order; default: one stage of all rails
+unsigned long MAX77650_shutdown(boolean = true, boolean = false); //Runs the sequence, then releases PWR_HLD and, if true, switches the PMIC off by software; dry run if the second parameter is true; Return Value: duration in µs; 0=I2C error (a failed flush of the scheduler drops the pending requests, the sequence still runs)
+unsigned long MAX77650_shutdown_getWorst_us(void); //Returns the longest duration of a sequence
 
+
+#endif
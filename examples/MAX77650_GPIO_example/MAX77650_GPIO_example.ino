@@ -0,0 +1,114 @@
+/**********************************************************************
+* Copyright (C) 2026 Maxim Integrated Products, Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+* 
+* Authors: 
+* Ole Dreessen; ole.dreessen@maximintegrated.com
+* 
+* Revisions:
+* 1.0.0       18.10.2026      initial code
+* 
+* 
+* The MAX77650/MAX77651 provide highly-integrated battery charging and 
+* power supply solutions for low-power wearable applications where size and efficiency 
+* are critical. Both devices feature a SIMO buck-boost regulator that provides three 
+* independently programmable power rails from a single inductor to minimize total solution 
+* size. A 150mA LDO provides ripple rejection for audio and other noise-sensitive applications. 
+* A highly configurable linear charger supports a wide range of Li+ battery capacities and 
+* includes battery temperature monitoring for additional safety (JEITA).
+*
+* The devices include other features such as current sinks for driving LED indicators and 
+* an analog multiplexer that switches several internal voltage and current signals to an 
+* external node for monitoring with an external ADC. A bidirectional I2C interface allows 
+* for configuring and checking the status of the devices. An internal on/off controller 
+* provides a controlled startup sequence for the regulators and provides supervisory 
+* functionality when the devices are on. Numerous factory programmable options allow the 
+* device to be tailored for many applications, enabling faster time to market.
+*
+* Ressources can be found at
+* https://www.maximintegrated.com/en/products/power/battery-management/MAX77650.html
+* https://www.maximintegrated.com/en/app-notes/index.mvp/id/6428
+* 
+* GPIO with edge events. The GPIO of the PMIC is configured as debounced
+* input in one write; its rising edge (e.g. a wake signal of a sensor) is
+* delivered by the interrupt service with the time the IRQ pin fired. As an
+* output (MAX77650_GPIO_OUTPUT_PP) a toggle costs one write.
+* 
+* Flow:
+* Initialize the PMIC and attach the IRQ pin
+*           v
+* Configure the GPIO as debounced input and unmask its rising edge
+*           v
+* Print the time of every wake edge
+* 
+**********************************************************************/
+
+// Includes
+#include <Wire.h>
+#include <MAX77650-Arduino-Library.h>
+
+//Definitions
+#define MAX77650_debug true
+#define MAX77650_IRQpin P2_3 //Pin 19 -> connected to MAX77650 IRQ output pin (C2)
+
+// Globals
+volatile boolean wake = false;
+
+void gpio_edge(byte edges, unsigned long time)
+{
+  if (edges & MAX77650_GPIO_RISING) {
+    wake = true;
+    if (MAX77650_debug) {
+      Serial.print("Wake edge at ");
+      Serial.print(time);
+      Serial.println("ms");
+    }
+  }
+}
+
+void setup(void)
+{
+  Serial.begin(115200);
+  if (!MAX77650_init() && MAX77650_debug) Serial.println("PMIC does not acknowledge");
+  pinMode(MAX77650_IRQpin, INPUT_PULLUP);
+  attachInterrupt(MAX77650_IRQpin, MAX77650_IRQ, FALLING);
+  MAX77650_gpio_mode(MAX77650_GPIO_INPUT | MAX77650_GPIO_DEBOUNCE);   //one write
+  MAX77650_gpio_onEdge(MAX77650_GPIO_RISING, gpio_edge);
+}
+
+void loop(void)
+{
+  if (MAX77650_interruptPending()) MAX77650_serviceInterrupts();
+  if (wake) {
+    wake = false;
+    //handle the wake signal here
+  }
+  //enter the sleep mode of your µC here; the IRQ pin wakes it
+}
@@ -0,0 +1,149 @@
+/**********************************************************************
+* Copyright (C) 2026 Maxim Integrated Products, Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+* 
+* Authors: 
+* Ole Dreessen; ole.dreessen@maximintegrated.com
+* 
+* Revisions:
+* 1.0.0       18.10.2026      initial code
+* 
+* 
+* The MAX77650/MAX77651 provide highly-integrated battery charging and 
+* power supply solutions for low-power wearable applications where size and efficiency 
+* are critical. Both devices feature a SIMO buck-boost regulator that provides three 
+* independently programmable power rails from a single inductor to minimize total solution 
+* size. A 150mA LDO provides ripple rejection for audio and other noise-sensitive applications. 
+* A highly configurable linear charger supports a wide range of Li+ battery capacities and 
+* includes battery temperature monitoring for additional safety (JEITA).
+*
+* The devices include other features such as current sinks for driving LED indicators and 
+* an analog multiplexer that switches several internal voltage and current signals to an 
+* external node for monitoring with an external ADC. A bidirectional I2C interface allows 
+* for configuring and checking the status of the devices. An internal on/off controller 
+* provides a controlled startup sequence for the regulators and provides supervisory 
+* functionality when the devices are on. Numerous factory programmable options allow the 
+* device to be tailored for many applications, enabling faster time to market.
+*
+* Ressources can be found at
+* https://www.maximintegrated.com/en/products/power/battery-management/MAX77650.html
+* https://www.maximintegrated.com/en/app-notes/index.mvp/id/6428
+* 
+* Sharing the MAX77650 between tasks of FreeRTOS. A lock with one recursive
+* mutex per register group lets a charging task, an LED task and a telemetry
+* task use the PMIC at the same time: read-modify-writes of a group are atomic,
+* tasks working on different groups do not wait for each other beyond the I2C
+* transfers themselves.
+* 
+* Flow:
+* Create one recursive mutex per lock group and set the lock of MAX77650_PMIC
+*           v
+* Initialize the PMIC
+*           v
+* Start the tasks: charger (CNFG_CHG), LED (CNFG_LED) and telemetry (status registers)
+* 
+**********************************************************************/
+
+// Includes
+#include <Wire.h>
+#include <FreeRTOS.h>
+#include <semphr.h>
+#include <task.h>
+#include <MAX77650-Arduino-Library.h>
+
+//Definitions
+#define MAX77650_debug true
+
+// Globals
+class MAX77650_freertos_lock : public MAX77650_lock {
+  public:
+    void begin(void) {
+      for (byte i = 0; i < MAX77650_LOCKS; i++)
+        mutex[i] = xSemaphoreCreateRecursiveMutex();
+    }
+    void lock(byte group) {
+      xSemaphoreTakeRecursive(mutex[group], portMAX_DELAY);
+    }
+    void unlock(byte group) {
+      xSemaphoreGiveRecursive(mutex[group]);
+    }
+  private:
+    SemaphoreHandle_t mutex[MAX77650_LOCKS];
+};
+
+MAX77650_freertos_lock PMIC_lock;
+
+void charger_task(void *parameters)
+{
+  for (;;) {
+    MAX77650_setCHG_CC(MAX77650_getICHGIN_LIM() ? 0b001011 : 0b000101);   //both setters are atomic read-modify-writes
+    MAX77650_setCHG_EN(true);
+    vTaskDelay(pdMS_TO_TICKS(500));
+  }
+}
+
+void led_task(void *parameters)
+{
+  boolean on = false;
+  for (;;) {
+    on = !on;
+    MAX77650_setBRT_LED0(on ? 0b11111 : 0);
+    vTaskDelay(pdMS_TO_TICKS(250));
+  }
+}
+
+void telemetry_task(void *parameters)
+{
+  for (;;) {
+    if (MAX77650_debug) {
+      Serial.print("STAT_CHG_B: ");
+      Serial.println(MAX77650_read_register(MAX77650_STAT_CHG_B_ADDR), HEX);
+    }
+    vTaskDelay(pdMS_TO_TICKS(1000));
+  }
+}
+
+void setup(void)
+{
+  Serial.begin(115200);
+  PMIC_lock.begin();
+  MAX77650_PMIC.setLock(&PMIC_lock);
+  if (!MAX77650_init() && MAX77650_debug) Serial.println("PMIC does not acknowledge");
+  MAX77650_setEN_LED_MSTR(true);
+  MAX77650_setLED_FS0(0b01);
+  xTaskCreate(charger_task, "charger", 256, NULL, 2, NULL);
+  xTaskCreate(led_task, "LED", 256, NULL, 1, NULL);
+  xTaskCreate(telemetry_task, "telemetry", 256, NULL, 1, NULL);
+  vTaskStartScheduler();
+}
+
+void loop(void)
+{
+}
@@ -34,6 +34,7 @@
 
   Revisions:
   1.0.0       21.03.2018      initial code
+  1.1.0       18.10.2026      SBB1 and SBB2 voltages converted with the tables of the detected part
 
 
   The MAX77650/MAX77651 provide highly-integrated battery charging and
@@ -130,36 +131,12 @@ void loop(void)
   Serial.print(MAX77650_getTV_SBB0() * 0.025 + 0.8);
   Serial.println("V");
 
-  //Read SBB1 voltage is more complex. See MAX77650 programmers manual page 40 for more details.
+  //SBB1 and SBB2 have other ranges on the MAX77651; the tables of the part detected by MAX77650_init are used
   Serial.print("SIMO Buck-Boost Voltage Channel 1: ");
-  if (MAX77650_getDIDM()) {
-    float SBB1_voltage = 0;
-    float lsb = 0.05;
-    float base_0 = 2.40;
-    float base_1 = 3.20;
-    float base_2 = 4.00;
-    float base_3 = 4.80;
-    float code_1_0 = 0;
-    byte code = MAX77650_getTV_SBB1();
-    code_1_0 = code & 0b11;
-    if (code_1_0 == 0b00)
-      SBB1_voltage = base_0;
-    else if (code_1_0 == 0b01)
-      SBB1_voltage = base_1;
-    else if (code_1_0 == 0b10)
-      SBB1_voltage = base_2;
-    else
-      SBB1_voltage = base_3;
-    float code_5_2 = (code >> 2);
-    SBB1_voltage = SBB1_voltage + code_5_2 * lsb;
-    Serial.print(SBB1_voltage);
-  } else 
-     Serial.print(MAX77650_getTV_SBB1() * 0.0125 + 0.8);
-  
+  Serial.print(MAX77650_PMIC.codeToVoltage(MAX77650_CNFG_SBB1_A_ADDR, MAX77650_getTV_SBB1()) / 1000.0);
   Serial.println("V");
   Serial.print("SIMO Buck-Boost Voltage Channel 2: ");
-  if (!(MAX77650_getDIDM())) Serial.print(MAX77650_getTV_SBB2() * 0.05 + 0.8);
-  else Serial.print(MAX77650_getTV_SBB2() * 0.05 + 2.4); //See MAX77650 programmers manual page 43 chapter 9.4.9
+  Serial.print(MAX77650_PMIC.codeToVoltage(MAX77650_CNFG_SBB2_A_ADDR, MAX77650_getTV_SBB2()) / 1000.0);
   Serial.println("V");
 }
 
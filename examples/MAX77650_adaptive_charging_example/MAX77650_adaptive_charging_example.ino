@@ -0,0 +1,116 @@
+/**********************************************************************
+* Copyright (C) 2026 Maxim Integrated Products, Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+* 
+* Authors: 
+* Ole Dreessen; ole.dreessen@maximintegrated.com
+* 
+* Revisions:
+* 1.0.0       18.10.2026      initial code
+* 
+* 
+* The MAX77650/MAX77651 provide highly-integrated battery charging and 
+* power supply solutions for low-power wearable applications where size and efficiency 
+* are critical. Both devices feature a SIMO buck-boost regulator that provides three 
+* independently programmable power rails from a single inductor to minimize total solution 
+* size. A 150mA LDO provides ripple rejection for audio and other noise-sensitive applications. 
+* A highly configurable linear charger supports a wide range of Li+ battery capacities and 
+* includes battery temperature monitoring for additional safety (JEITA).
+*
+* The devices include other features such as current sinks for driving LED indicators and 
+* an analog multiplexer that switches several internal voltage and current signals to an 
+* external node for monitoring with an external ADC. A bidirectional I2C interface allows 
+* for configuring and checking the status of the devices. An internal on/off controller 
+* provides a controlled startup sequence for the regulators and provides supervisory 
+* functionality when the devices are on. Numerous factory programmable options allow the 
+* device to be tailored for many applications, enabling faster time to market.
+*
+* Ressources can be found at
+* https://www.maximintegrated.com/en/products/power/battery-management/MAX77650.html
+* https://www.maximintegrated.com/en/app-notes/index.mvp/id/6428
+* 
+* Flow:
+* Apply a charger profile and start the controller with the ceilings of the profile
+*           v
+* Attach the IRQ pin to MAX77650_IRQ
+*           v
+* loop(): service pending interrupts and tick the controller; no status polling
+* 
+**********************************************************************/
+
+//Pin Definitions
+#define MAX77650_IRQpin P2_3 //Pin 19 -> connected to MAX77650 IRQ output pin (C2)
+
+// Includes
+#include <Wire.h>
+#include <MAX77650-Arduino-Library.h>
+
+#define MAX77650_debug true
+
+constexpr MAX77650_charger_profile MAX77650_profile = MAX77650_charger_profile()
+  .THM_COLD_C(0).THM_COOL_C(15).THM_WARM_C(45).THM_HOT_C(60)
+  .VCHGIN_MIN_mV(4300).ICHGIN_LIM_mA(95).CHG_EN(true)          //start low, the controller raises the input limit
+  .CHG_PQ_mV(3000).I_TERM_permille(150).TJ_REG_C(60).VSYS_REG_mV(4500)
+  .CHG_CC_mA(150).T_FAST_CHG_h(5).CHG_CC_JEITA_mA(150).THM_EN(true)
+  .CHG_CV_mV(4200).CHG_CV_JEITA_mV(4000).IMON_DISCHG_SCALE_mA(300);
+
+// Globals
+unsigned long UART_last_millies = 0;
+
+void setup(void)
+{
+  Serial.begin(115200);
+  MAX77650_init();
+
+  if (MAX77650_debug) Serial.print("Apply charger profile: ");
+  if (MAX77650_applyChargerProfile(MAX77650_profile)) if (MAX77650_debug) Serial.println("okay"); else if (MAX77650_debug) Serial.println("failed");
+  if (MAX77650_debug) Serial.print("Start charge-current controller (300mA / 475mA): ");
+  if (MAX77650_chargeController_begin(MAX77650_CHG_CC_mA(300), MAX77650_ICHGIN_LIM_mA(475))) if (MAX77650_debug) Serial.println("okay"); else if (MAX77650_debug) Serial.println("failed");
+
+  //MAX77650 Interrupt wiring
+  pinMode(MAX77650_IRQpin, INPUT_PULLUP);
+  attachInterrupt(MAX77650_IRQpin, MAX77650_IRQ, FALLING);
+  MAX77650_serviceInterrupts();   //read and clear the interrupt registers
+}
+
+void loop(void)
+{
+  if (MAX77650_interruptPending())
+   MAX77650_serviceInterrupts();
+  MAX77650_chargeController_tick();
+
+  if (MAX77650_debug && (millis() - UART_last_millies >= 3000)) {
+    Serial.print("CHG_CC code: ");
+    Serial.print(MAX77650_chargeController_getCHG_CC());
+    Serial.print(" ICHGIN_LIM code: ");
+    Serial.println(MAX77650_chargeController_getICHGIN_LIM());
+    UART_last_millies = millis();
+  }
+}
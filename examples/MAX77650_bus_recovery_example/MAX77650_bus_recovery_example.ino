@@ -0,0 +1,115 @@
+/**********************************************************************
+* Copyright (C) 2026 Maxim Integrated Products, Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+* 
+* Authors: 
+* Ole Dreessen; ole.dreessen@maximintegrated.com
+* 
+* Revisions:
+* 1.0.0       18.10.2026      initial code
+* 
+* 
+* The MAX77650/MAX77651 provide highly-integrated battery charging and 
+* power supply solutions for low-power wearable applications where size and efficiency 
+* are critical. Both devices feature a SIMO buck-boost regulator that provides three 
+* independently programmable power rails from a single inductor to minimize total solution 
+* size. A 150mA LDO provides ripple rejection for audio and other noise-sensitive applications. 
+* A highly configurable linear charger supports a wide range of Li+ battery capacities and 
+* includes battery temperature monitoring for additional safety (JEITA).
+*
+* The devices include other features such as current sinks for driving LED indicators and 
+* an analog multiplexer that switches several internal voltage and current signals to an 
+* external node for monitoring with an external ADC. A bidirectional I2C interface allows 
+* for configuring and checking the status of the devices. An internal on/off controller 
+* provides a controlled startup sequence for the regulators and provides supervisory 
+* functionality when the devices are on. Numerous factory programmable options allow the 
+* device to be tailored for many applications, enabling faster time to market.
+*
+* Ressources can be found at
+* https://www.maximintegrated.com/en/products/power/battery-management/MAX77650.html
+* https://www.maximintegrated.com/en/app-notes/index.mvp/id/6428
+* 
+* Recovery of a stuck I2C bus. If the µC is reset in the middle of a transfer,
+* the PMIC may hold SDA low and every following transfer would hang. With its
+* SDA and SCL pins the transport detects the stuck bus, clocks SCL until the
+* PMIC releases SDA, sends a STOP and restarts the I2C port. The watchdog is
+* fed while the driver repeats the transfer.
+* 
+* Flow:
+* Create a transport with the SDA and SCL pins of the I2C port and use it for MAX77650_PMIC
+*           v
+* Feed the watchdog from the driver during repetitions
+*           v
+* Print the transfer counters every second
+* 
+**********************************************************************/
+
+// Includes
+#include <Wire.h>
+#include <MAX77650-Arduino-Library.h>
+
+//Definitions
+#define MAX77650_debug true
+#define MAX77650_SDApin 20   //SDA pin of the I2C port connected to the MAX77650 (adapt to your board)
+#define MAX77650_SCLpin 21   //SCL pin of the I2C port connected to the MAX77650 (adapt to your board)
+
+// Globals
+MAX77650_wire_transport MAX77650_bus(Wire2, MAX77650_SDApin, MAX77650_SCLpin);
+
+void feed_watchdog(void)
+{
+  //call the watchdog reload function of your µC here
+}
+
+void setup(void)
+{
+  Serial.begin(115200);
+  MAX77650_PMIC.setTransport(MAX77650_bus);
+  MAX77650_PMIC.setWatchdog(feed_watchdog);
+  if (!MAX77650_init() && MAX77650_debug) Serial.println("PMIC does not acknowledge");
+}
+
+void loop(void)
+{
+  if (MAX77650_read_register(MAX77650_STAT_CHG_B_ADDR) < 0 && MAX77650_debug) {
+    Serial.print("Transfer failed, error ");
+    Serial.println(MAX77650_getLastError());
+  }
+  const MAX77650_bus_stats &stats = MAX77650_PMIC.getBusStats();
+  if (MAX77650_debug) {
+    Serial.print("transfers: "); Serial.print(stats.transfers);
+    Serial.print(" retries: "); Serial.print(stats.retries);
+    Serial.print(" errors: "); Serial.print(stats.errors);
+    Serial.print(" recoveries: "); Serial.print(stats.recoveries);
+    Serial.print(" worst [us]: "); Serial.println(stats.worst_us);
+  }
+  feed_watchdog();
+  delay(1000);
+}
@@ -0,0 +1,113 @@
+/**********************************************************************
+* Copyright (C) 2026 Maxim Integrated Products, Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+* 
+* Authors: 
+* Ole Dreessen; ole.dreessen@maximintegrated.com
+* 
+* Revisions:
+* 1.0.0       18.10.2026      initial code
+* 
+* 
+* The MAX77650/MAX77651 provide highly-integrated battery charging and 
+* power supply solutions for low-power wearable applications where size and efficiency 
+* are critical. Both devices feature a SIMO buck-boost regulator that provides three 
+* independently programmable power rails from a single inductor to minimize total solution 
+* size. A 150mA LDO provides ripple rejection for audio and other noise-sensitive applications. 
+* A highly configurable linear charger supports a wide range of Li+ battery capacities and 
+* includes battery temperature monitoring for additional safety (JEITA).
+*
+* The devices include other features such as current sinks for driving LED indicators and 
+* an analog multiplexer that switches several internal voltage and current signals to an 
+* external node for monitoring with an external ADC. A bidirectional I2C interface allows 
+* for configuring and checking the status of the devices. An internal on/off controller 
+* provides a controlled startup sequence for the regulators and provides supervisory 
+* functionality when the devices are on. Numerous factory programmable options allow the 
+* device to be tailored for many applications, enabling faster time to market.
+*
+* Ressources can be found at
+* https://www.maximintegrated.com/en/products/power/battery-management/MAX77650.html
+* https://www.maximintegrated.com/en/app-notes/index.mvp/id/6428
+* 
+* Flow:
+* Declare the charger profiles at compile time (values in physical units)
+*           v
+* Apply the normal profile in one burst write
+*           v
+* Switch to the warm profile while the battery is warm and back again
+* 
+**********************************************************************/
+
+// Includes
+#include <Wire.h>
+#include <MAX77650-Arduino-Library.h>
+
+#define MAX77650_debug true
+
+//Charger profiles for a 1s 303759 battery with 600mAh and a NTC with beta=3800K
+//A value out of range (e.g. CHG_CC_mA(400)) stops the compilation
+constexpr MAX77650_charger_profile MAX77650_profile_normal = MAX77650_charger_profile()
+  .THM_COLD_C(0).THM_COOL_C(15).THM_WARM_C(45).THM_HOT_C(60)        //JEITA temperature thresholds
+  .VCHGIN_MIN_mV(4000).ICHGIN_LIM_mA(380).I_PQ_percent(10).CHG_EN(true)
+  .CHG_PQ_mV(3000).I_TERM_permille(150).T_TOPOFF_min(0)
+  .TJ_REG_C(60).VSYS_REG_mV(4500)
+  .CHG_CC_mA(300).T_FAST_CHG_h(5)
+  .CHG_CC_JEITA_mA(300).THM_EN(true)
+  .CHG_CV_mV(4200).USBS(false)
+  .CHG_CV_JEITA_mV(4000)
+  .IMON_DISCHG_SCALE_mA(300).MUX_SEL(0);
+
+//Same battery, reduced charge current and voltage while the battery is warm
+constexpr MAX77650_charger_profile MAX77650_profile_warm = MAX77650_profile_normal
+  .CHG_CC_mA(150).CHG_CV_mV(4100);
+
+// Globals
+boolean warm = false;
+
+void setup(void)
+{
+  Serial.begin(115200);
+  MAX77650_init();
+
+  if (MAX77650_debug) Serial.print("Apply normal charger profile: ");
+  if (MAX77650_applyChargerProfile(MAX77650_profile_normal)) if (MAX77650_debug) Serial.println("okay"); else if (MAX77650_debug) Serial.println("failed");
+}
+
+void loop(void)
+{
+  //THM_DTLS 0x3 = battery is warm (TWARM < T < THOT)
+  boolean battery_warm = (MAX77650_getTHM_DTLS() == 0x3);
+  if (battery_warm != warm) {
+    warm = battery_warm;
+    if (MAX77650_debug) Serial.print(warm ? "Battery warm, apply warm profile: " : "Battery normal, apply normal profile: ");
+    if (MAX77650_applyChargerProfile(warm ? MAX77650_profile_warm : MAX77650_profile_normal)) if (MAX77650_debug) Serial.println("okay"); else if (MAX77650_debug) Serial.println("failed");
+  }
+  delay(1000);
+}
@@ -0,0 +1,128 @@
+/**********************************************************************
+* Copyright (C) 2026 Maxim Integrated Products, Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+* 
+* Authors: 
+* Ole Dreessen; ole.dreessen@maximintegrated.com
+* 
+* Revisions:
+* 1.0.0       18.10.2026      initial code
+* 
+* 
+* The MAX77650/MAX77651 provide highly-integrated battery charging and 
+* power supply solutions for low-power wearable applications where size and efficiency 
+* are critical. Both devices feature a SIMO buck-boost regulator that provides three 
+* independently programmable power rails from a single inductor to minimize total solution 
+* size. A 150mA LDO provides ripple rejection for audio and other noise-sensitive applications. 
+* A highly configurable linear charger supports a wide range of Li+ battery capacities and 
+* includes battery temperature monitoring for additional safety (JEITA).
+*
+* The devices include other features such as current sinks for driving LED indicators and 
+* an analog multiplexer that switches several internal voltage and current signals to an 
+* external node for monitoring with an external ADC. A bidirectional I2C interface allows 
+* for configuring and checking the status of the devices. An internal on/off controller 
+* provides a controlled startup sequence for the regulators and provides supervisory 
+* functionality when the devices are on. Numerous factory programmable options allow the 
+* device to be tailored for many applications, enabling faster time to market.
+*
+* Ressources can be found at
+* https://www.maximintegrated.com/en/products/power/battery-management/MAX77650.html
+* https://www.maximintegrated.com/en/app-notes/index.mvp/id/6428
+* 
+* Power budget. The loads of the rails are described by their currents when
+* active and idle; the application reports their activity, here a radio on
+* SBB2 sending for 50ms every second. The battery power is measured with the
+* AMUX every minute and corrects the model. The budget tells the remaining
+* runtime, e.g. to postpone work while the battery is low.
+* 
+* Flow:
+* Initialize the PMIC and the AMUX reader
+*           v
+* Start the estimator with the energy of the battery and the load models
+*           v
+* Report the activity of the radio
+*           v
+* Measure every minute, print the budget every 10 seconds
+* 
+**********************************************************************/
+
+// Includes
+#include <Wire.h>
+#include <MAX77650-Arduino-Library.h>
+
+//Definitions
+#define MAX77650_debug true
+#define AMUX_pin 52                 //ADC pin connected to the AMUX of the MAX77650 (adapt to your board)
+#define BATTERY_uWh 2220000UL       //600mAh at 3.7V
+
+// Globals
+unsigned long last_send = 0;
+unsigned long last_measure = 0;
+unsigned long last_print = 0;
+
+int read_amux(void)
+{
+  return analogRead(AMUX_pin);
+}
+
+void setup(void)
+{
+  Serial.begin(115200);
+  if (!MAX77650_init() && MAX77650_debug) Serial.println("PMIC does not acknowledge");
+  MAX77650_setAMUXReader(read_amux, 1067, 5);   //1.25V full-scale of the AMUX on a 1.2V/1024 ADC
+  MAX77650_energy_setLoad(MAX77650_ENERGY_SBB0, 3000, 3000);    //µC core
+  MAX77650_energy_setLoad(MAX77650_ENERGY_SBB2, 25000, 50);     //radio: sending, sleeping
+  MAX77650_energy_setLoad(MAX77650_ENERGY_LDO, 500, 500, 55);   //sensor on the LDO fed from the battery
+  MAX77650_energy_begin(BATTERY_uWh);
+}
+
+void loop(void)
+{
+  if (millis() - last_send >= 1000) {
+    last_send = millis();
+    MAX77650_energy_setActive(MAX77650_ENERGY_SBB2, true);
+    delay(50);   //send
+    MAX77650_energy_setActive(MAX77650_ENERGY_SBB2, false);
+  }
+  if (millis() - last_measure >= 60000) {
+    last_measure = millis();
+    MAX77650_energy_measure();
+  }
+  if (millis() - last_print >= 10000 && MAX77650_debug) {
+    last_print = millis();
+    MAX77650_energy_budget budget;
+    MAX77650_energy_getBudget(budget);
+    Serial.print("power: "); Serial.print(budget.power_uW);
+    Serial.print("uW used: "); Serial.print(budget.used_uWh);
+    Serial.print("uWh radio active: "); Serial.print(budget.duty[MAX77650_ENERGY_SBB2]);
+    Serial.print("% runtime left: "); Serial.print(budget.runtime_s / 3600);
+    Serial.println("h");
+  }
+}
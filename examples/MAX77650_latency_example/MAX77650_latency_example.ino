@@ -0,0 +1,129 @@
+/**********************************************************************
+* Copyright (C) 2026 Maxim Integrated Products, Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+* 
+* Authors: 
+* Ole Dreessen; ole.dreessen@maximintegrated.com
+* 
+* Revisions:
+* 1.0.0       18.10.2026      initial code
+* 
+* 
+* The MAX77650/MAX77651 provide highly-integrated battery charging and 
+* power supply solutions for low-power wearable applications where size and efficiency 
+* are critical. Both devices feature a SIMO buck-boost regulator that provides three 
+* independently programmable power rails from a single inductor to minimize total solution 
+* size. A 150mA LDO provides ripple rejection for audio and other noise-sensitive applications. 
+* A highly configurable linear charger supports a wide range of Li+ battery capacities and 
+* includes battery temperature monitoring for additional safety (JEITA).
+*
+* The devices include other features such as current sinks for driving LED indicators and 
+* an analog multiplexer that switches several internal voltage and current signals to an 
+* external node for monitoring with an external ADC. A bidirectional I2C interface allows 
+* for configuring and checking the status of the devices. An internal on/off controller 
+* provides a controlled startup sequence for the regulators and provides supervisory 
+* functionality when the devices are on. Numerous factory programmable options allow the 
+* device to be tailored for many applications, enabling faster time to market.
+*
+* Ressources can be found at
+* https://www.maximintegrated.com/en/products/power/battery-management/MAX77650.html
+* https://www.maximintegrated.com/en/app-notes/index.mvp/id/6428
+* 
+* Latency histograms of the PMIC operations. Set MAX77650_LATENCY_HISTOGRAMS
+* to true in the project specific definitions of MAX77650-Arduino-Library.h.
+* Every 10 seconds the histograms of I2C reads, writes, read-modify-writes,
+* interrupt service and AMUX measurements are printed with their median,
+* 99th percentile and worst case, so rare long stalls of the PMIC show up
+* next to the average.
+* 
+* Flow:
+* Initialize the PMIC
+*           v
+* Work with the PMIC (LED brightness, status reads, interrupt service)
+*           v
+* Print the histograms every 10 seconds
+* 
+**********************************************************************/
+
+// Includes
+#include <Wire.h>
+#include <MAX77650-Arduino-Library.h>
+
+//Definitions
+#define MAX77650_debug true
+#define MAX77650_IRQpin P2_3 //Pin 19 -> connected to MAX77650 IRQ output pin (C2)
+
+// Globals
+const char *class_names[MAX77650_LAT_CLASSES] = {"read", "write", "RMW", "IRQ", "AMUX"};
+unsigned long last_print = 0;
+byte brightness = 0;
+
+void print_histograms(void)
+{
+  for (byte c = 0; c < MAX77650_LAT_CLASSES; c++) {
+    const MAX77650_histogram &h = MAX77650_getHistogram(c);
+    Serial.print(class_names[c]);
+    Serial.print(": n="); Serial.print(h.count);
+    if (h.count) {
+      Serial.print(" mean="); Serial.print(h.total_us / h.count);
+      Serial.print("us p50<="); Serial.print(MAX77650_getPercentile_us(c, 50));
+      Serial.print("us p99<="); Serial.print(MAX77650_getPercentile_us(c, 99));
+      Serial.print("us max="); Serial.print(h.max_us);
+      Serial.print("us |");
+      for (byte i = 0; i < MAX77650_HIST_BUCKETS; i++) {
+        Serial.print(' ');
+        Serial.print(h.bucket[i]);
+      }
+    }
+    Serial.println();
+  }
+}
+
+void setup(void)
+{
+  Serial.begin(115200);
+  if (!MAX77650_init() && MAX77650_debug) Serial.println("PMIC does not acknowledge");
+  MAX77650_setEN_LED_MSTR(true);
+  pinMode(MAX77650_IRQpin, INPUT_PULLUP);
+  attachInterrupt(MAX77650_IRQpin, MAX77650_IRQ, FALLING);
+}
+
+void loop(void)
+{
+  brightness = (brightness + 1) & 0b00011111;
+  MAX77650_setBRT_LED0(brightness);
+  MAX77650_getCHG_DTLS();
+  if (MAX77650_interruptPending()) MAX77650_serviceInterrupts();
+  if (millis() - last_print >= 10000) {
+    last_print = millis();
+    print_histograms();
+  }
+  delay(20);
+}
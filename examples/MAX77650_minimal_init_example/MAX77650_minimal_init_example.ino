@@ -0,0 +1,140 @@
+/**********************************************************************
+* Copyright (C) 2026 Maxim Integrated Products, Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+* 
+* Authors: 
+* Ole Dreessen; ole.dreessen@maximintegrated.com
+* 
+* Revisions:
+* 1.0.0       18.10.2026      initial code
+* 
+* 
+* The MAX77650/MAX77651 provide highly-integrated battery charging and 
+* power supply solutions for low-power wearable applications where size and efficiency 
+* are critical. Both devices feature a SIMO buck-boost regulator that provides three 
+* independently programmable power rails from a single inductor to minimize total solution 
+* size. A 150mA LDO provides ripple rejection for audio and other noise-sensitive applications. 
+* A highly configurable linear charger supports a wide range of Li+ battery capacities and 
+* includes battery temperature monitoring for additional safety (JEITA).
+*
+* The devices include other features such as current sinks for driving LED indicators and 
+* an analog multiplexer that switches several internal voltage and current signals to an 
+* external node for monitoring with an external ADC. A bidirectional I2C interface allows 
+* for configuring and checking the status of the devices. An internal on/off controller 
+* provides a controlled startup sequence for the regulators and provides supervisory 
+* functionality when the devices are on. Numerous factory programmable options allow the 
+* device to be tailored for many applications, enabling faster time to market.
+*
+* Ressources can be found at
+* https://www.maximintegrated.com/en/products/power/battery-management/MAX77650.html
+* https://www.maximintegrated.com/en/app-notes/index.mvp/id/6428
+* 
+* The baseline initialization of the MAX77650_complete_init_example as one
+* configuration. applyConfig reads the live registers in a few burst reads and
+* writes only the registers whose value differs from the reset/OTP defaults,
+* neighbouring registers coalesced into one burst write.
+* 
+* Flow:
+* Describe the desired configuration field by field
+*           v
+* applyConfig: burst-read the live image, diff, write the differences in bursts
+*           v
+* Report the number of burst writes (0 after a warm restart with unchanged registers)
+* 
+**********************************************************************/
+
+// Includes
+#include <Wire.h>
+#include <MAX77650-Arduino-Library.h>
+
+//Definitions
+#define MAX77650_debug true
+#define MAX77650_PHLD P2_2   //Pin 18 -> connected to MAX77650 power hold input pin (A1)
+
+void setup(void)
+{
+  //Configure the Power-Management (Power-Hold)
+  pinMode(MAX77650_PHLD, OUTPUT);          //configure pin as output
+  digitalWrite(MAX77650_PHLD, HIGH);       //set output to HIGH to hold the power-on state
+
+  Serial.begin(115200);
+  MAX77650_init();
+
+  //Baseline Initialization following rules printed in MAX77650 Programmres Guide Chapter 4 Page 5
+  MAX77650_config baseline;
+  baseline.set(MAX77650_FIELD_SBIA_LPM, false)      //Main Bias in normal Mode
+          .set(MAX77650_FIELD_nEN_MODE, false)      //On/Off-Button in push-button-mode
+          .set(MAX77650_FIELD_DBEN_nEN, true)       //nEN input debounce time 30ms
+          .set(MAX77650_FIELD_THM_COLD, 2)          //VCOLD 0°C
+          .set(MAX77650_FIELD_THM_COOL, 3)          //VCOOL 15°C
+          .set(MAX77650_FIELD_THM_WARM, 2)          //VWARM 45°C
+          .set(MAX77650_FIELD_THM_HOT, 3)           //VHOT 60°C
+          .set(MAX77650_FIELD_VCHGIN_MIN, 0)        //CHGIN regulation voltage 4.00V
+          .set(MAX77650_FIELD_ICHGIN_LIM, 0)        //CHGIN input current limit 95mA
+          .set(MAX77650_FIELD_I_PQ, false)          //prequalification charge current 10%
+          .set(MAX77650_FIELD_CHG_PQ, 7)            //prequalification voltage threshold 3.0V
+          .set(MAX77650_FIELD_I_TERM, 3)            //termination current 15%
+          .set(MAX77650_FIELD_T_TOPOFF, 0)          //topoff timer 0 minutes
+          .set(MAX77650_FIELD_TJ_REG, 0)            //die junction temperature regulation 60°C
+          .set(MAX77650_FIELD_VSYS_REG, 0x10)       //system voltage regulation 4.50V
+          .set(MAX77650_FIELD_CHG_CC, 0x27)         //fast-charge current 300mA
+          .set(MAX77650_FIELD_T_FAST_CHG, 1)        //fast-charge safety timer 3h
+          .set(MAX77650_FIELD_CHG_CC_JEITA, 0x27)   //IFAST-CHG_JEITA 300mA
+          .set(MAX77650_FIELD_THM_EN, true)         //thermistor monitoring enabled
+          .set(MAX77650_FIELD_CHG_CV, 0x18)         //fast-charge battery regulation voltage 4.20V
+          .set(MAX77650_FIELD_USBS, false)          //CHGIN not suspended
+          .set(MAX77650_FIELD_CHG_CV_JEITA, 0x10)   //modified VFAST-CHG 4.00V
+          .set(MAX77650_FIELD_IMON_DISCHG_SCALE, 0x0A) //discharge current full-scale 300mA
+          .set(MAX77650_FIELD_MUX_SEL, 0)           //AMUX off
+          .set(MAX77650_FIELD_CHG_EN, true)         //charger enabled
+          .set(MAX77650_FIELD_ADE_SBB0, false)      //no active-discharge of the SIMO channels
+          .set(MAX77650_FIELD_ADE_SBB1, false)
+          .set(MAX77650_FIELD_ADE_SBB2, false)
+          .set(MAX77650_FIELD_DRV_SBB, 0b00)        //SIMO maximum drive strength
+          .set(MAX77650_FIELD_IP_SBB0, 0b00)        //SIMO peak current limits 1000mA
+          .set(MAX77650_FIELD_IP_SBB1, 0b00)
+          .set(MAX77650_FIELD_IP_SBB2, 0b00)
+          .set(MAX77650_FIELD_EN_SBB2, 0b110)       //SBB2 on
+          .set(MAX77650_FIELD_INT_M_GLBL, 0x00)     //all interrupts unmasked
+          .set(MAX77650_FIELD_INT_M_CHG, 0x00);
+
+  int bursts = MAX77650_applyConfig(baseline);
+  if (MAX77650_debug) {
+    if (bursts < 0) Serial.println("Baseline initialization failed");
+    else {
+      Serial.print("Baseline initialization done with burst writes: ");
+      Serial.println(bursts);
+    }
+  }
+}
+
+void loop(void)
+{
+}
@@ -0,0 +1,107 @@
+/**********************************************************************
+* Copyright (C) 2026 Maxim Integrated Products, Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+* 
+* Authors: 
+* Ole Dreessen; ole.dreessen@maximintegrated.com
+* 
+* Revisions:
+* 1.0.0       18.10.2026      initial code
+* 
+* 
+* The MAX77650/MAX77651 provide highly-integrated battery charging and 
+* power supply solutions for low-power wearable applications where size and efficiency 
+* are critical. Both devices feature a SIMO buck-boost regulator that provides three 
+* independently programmable power rails from a single inductor to minimize total solution 
+* size. A 150mA LDO provides ripple rejection for audio and other noise-sensitive applications. 
+* A highly configurable linear charger supports a wide range of Li+ battery capacities and 
+* includes battery temperature monitoring for additional safety (JEITA).
+*
+* The devices include other features such as current sinks for driving LED indicators and 
+* an analog multiplexer that switches several internal voltage and current signals to an 
+* external node for monitoring with an external ADC. A bidirectional I2C interface allows 
+* for configuring and checking the status of the devices. An internal on/off controller 
+* provides a controlled startup sequence for the regulators and provides supervisory 
+* functionality when the devices are on. Numerous factory programmable options allow the 
+* device to be tailored for many applications, enabling faster time to market.
+*
+* Ressources can be found at
+* https://www.maximintegrated.com/en/products/power/battery-management/MAX77650.html
+* https://www.maximintegrated.com/en/app-notes/index.mvp/id/6428
+* 
+* Two MAX77650 on one host: the second PMIC has its ADDR pin strapped for 0x40
+* (or sits on another I2C port). Every PMIC gets its own MAX77650 object with
+* its own register shadow.
+* 
+* Flow:
+* Create one object per PMIC (transport of the I2C port, address)
+*           v
+* Start both objects; check that both acknowledge
+*           v
+* Set the LED brightness of each PMIC with setField; a cached register costs one write
+* 
+**********************************************************************/
+
+// Includes
+#include <Wire.h>
+#include <MAX77650-Arduino-Library.h>
+
+#define MAX77650_debug true
+
+// Globals
+MAX77650_wire_transport MAX77650_bus(Wire2);
+MAX77650 MAX77650_main(MAX77650_bus, 0x48);   //PMIC powering the host
+MAX77650 MAX77650_aux(MAX77650_bus, 0x40);    //PMIC powering the sensor board
+byte brightness = 0;
+
+void setup(void)
+{
+  Serial.begin(115200);
+  if (!MAX77650_main.begin() && MAX77650_debug) Serial.println("PMIC at 0x48 does not acknowledge");
+  if (!MAX77650_aux.begin() && MAX77650_debug) Serial.println("PMIC at 0x40 does not acknowledge");
+
+  //LED0 of both PMICs: 12.8mA full scale, always on
+  MAX77650 *pmic[] = {&MAX77650_main, &MAX77650_aux};
+  for (byte i = 0; i < 2; i++) {
+    pmic[i]->setField(MAX77650_FIELD_LED_FS0, 0b11);
+    pmic[i]->setField(MAX77650_FIELD_P_LED0, 0b1111);
+    pmic[i]->setField(MAX77650_FIELD_D_LED0, 0b1111);
+    pmic[i]->setField(MAX77650_FIELD_EN_LED_MSTR, true);
+  }
+}
+
+void loop(void)
+{
+  //fade LED0 of the main PMIC in and the one of the auxiliary PMIC out
+  brightness = (brightness + 1) & 0b11111;
+  MAX77650_main.setField(MAX77650_FIELD_BRT_LED0, brightness);
+  MAX77650_aux.setField(MAX77650_FIELD_BRT_LED0, 0b11111 - brightness);
+  delay(50);
+}
@@ -0,0 +1,120 @@
+/**********************************************************************
+* Copyright (C) 2026 Maxim Integrated Products, Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+* 
+* Authors: 
+* Ole Dreessen; ole.dreessen@maximintegrated.com
+* 
+* Revisions:
+* 1.0.0       18.10.2026      initial code
+* 
+* 
+* The MAX77650/MAX77651 provide highly-integrated battery charging and 
+* power supply solutions for low-power wearable applications where size and efficiency 
+* are critical. Both devices feature a SIMO buck-boost regulator that provides three 
+* independently programmable power rails from a single inductor to minimize total solution 
+* size. A 150mA LDO provides ripple rejection for audio and other noise-sensitive applications. 
+* A highly configurable linear charger supports a wide range of Li+ battery capacities and 
+* includes battery temperature monitoring for additional safety (JEITA).
+*
+* The devices include other features such as current sinks for driving LED indicators and 
+* an analog multiplexer that switches several internal voltage and current signals to an 
+* external node for monitoring with an external ADC. A bidirectional I2C interface allows 
+* for configuring and checking the status of the devices. An internal on/off controller 
+* provides a controlled startup sequence for the regulators and provides supervisory 
+* functionality when the devices are on. Numerous factory programmable options allow the 
+* device to be tailored for many applications, enabling faster time to market.
+*
+* Ressources can be found at
+* https://www.maximintegrated.com/en/products/power/battery-management/MAX77650.html
+* https://www.maximintegrated.com/en/app-notes/index.mvp/id/6428
+* 
+* Request scheduler. An LED animation posts brightness values faster than
+* the bus needs to carry them: only the latest value of BRT_LED0 and BRT_LED1
+* is written. The charge current is posted with a deadline. When the
+* thermistor reports a hot battery, SBB2 is switched off with a critical
+* request which is written at once, ahead of the queued LED writes.
+* 
+* Flow:
+* Initialize the PMIC
+*           v
+* Post the LED brightness every 10ms (class LOW)
+*           v
+* Post the charge current every second (class NORMAL, deadline 100ms)
+*           v
+* Switch SBB2 off at once when the battery is hot (class CRITICAL)
+*           v
+* Write one queued request per pass of loop()
+* 
+**********************************************************************/
+
+// Includes
+#include <Wire.h>
+#include <MAX77650-Arduino-Library.h>
+
+//Definitions
+#define MAX77650_debug true
+
+// Globals
+unsigned long last_led = 0;
+unsigned long last_charger = 0;
+byte brightness = 0;
+
+void setup(void)
+{
+  Serial.begin(115200);
+  if (!MAX77650_init() && MAX77650_debug) Serial.println("PMIC does not acknowledge");
+  MAX77650_setEN_LED_MSTR(true);
+}
+
+void loop(void)
+{
+  if (millis() - last_led >= 10) {
+    last_led = millis();
+    brightness = (brightness + 1) & 0b00011111;
+    MAX77650_post(MAX77650_FIELD_BRT_LED0, brightness, MAX77650_PRIO_LOW);
+    MAX77650_post(MAX77650_FIELD_BRT_LED1, 0b00011111 - brightness, MAX77650_PRIO_LOW);
+  }
+  if (millis() - last_charger >= 1000) {
+    last_charger = millis();
+    if (MAX77650_getTHM_DTLS() == MAX77650_THM_HOT)
+      MAX77650_post(MAX77650_FIELD_EN_SBB2, 0b100, MAX77650_PRIO_CRITICAL);   //off at once
+    else
+      MAX77650_post(MAX77650_FIELD_CHG_CC, MAX77650_getTJ_REG_STAT() ? 0b000101 : 0b001011, MAX77650_PRIO_NORMAL, 100);
+    if (MAX77650_debug) {
+      const MAX77650_scheduler_stats &stats = MAX77650_scheduler_getStats();
+      Serial.print("posted: "); Serial.print(stats.posted);
+      Serial.print(" coalesced: "); Serial.print(stats.coalesced);
+      Serial.print(" written: "); Serial.print(stats.executed);
+      Serial.print(" late: "); Serial.println(stats.late);
+    }
+  }
+  MAX77650_scheduler_tick();
+}
@@ -0,0 +1,106 @@
+/**********************************************************************
+* Copyright (C) 2026 Maxim Integrated Products, Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+* 
+* Authors: 
+* Ole Dreessen; ole.dreessen@maximintegrated.com
+* 
+* Revisions:
+* 1.0.0       18.10.2026      initial code
+* 
+* 
+* The MAX77650/MAX77651 provide highly-integrated battery charging and 
+* power supply solutions for low-power wearable applications where size and efficiency 
+* are critical. Both devices feature a SIMO buck-boost regulator that provides three 
+* independently programmable power rails from a single inductor to minimize total solution 
+* size. A 150mA LDO provides ripple rejection for audio and other noise-sensitive applications. 
+* A highly configurable linear charger supports a wide range of Li+ battery capacities and 
+* includes battery temperature monitoring for additional safety (JEITA).
+*
+* The devices include other features such as current sinks for driving LED indicators and 
+* an analog multiplexer that switches several internal voltage and current signals to an 
+* external node for monitoring with an external ADC. A bidirectional I2C interface allows 
+* for configuring and checking the status of the devices. An internal on/off controller 
+* provides a controlled startup sequence for the regulators and provides supervisory 
+* functionality when the devices are on. Numerous factory programmable options allow the 
+* device to be tailored for many applications, enabling faster time to market.
+*
+* Ressources can be found at
+* https://www.maximintegrated.com/en/products/power/battery-management/MAX77650.html
+* https://www.maximintegrated.com/en/app-notes/index.mvp/id/6428
+* 
+* Background scrubbing of the PMIC configuration. Every call of MAX77650_scrub
+* compares the next 4 cached registers with the shadow in one burst read and
+* rewrites registers which were changed behind the back of the driver (e.g. by
+* ESD or a brown-out). Every diverged register is reported.
+* 
+* Flow:
+* Configure the PMIC through the setters (fills the shadow)
+*           v
+* Set the budget (registers per call) and the report callback
+*           v
+* Call MAX77650_scrub every 100ms; a pass over all registers takes a few calls
+* 
+**********************************************************************/
+
+// Includes
+#include <Wire.h>
+#include <MAX77650-Arduino-Library.h>
+
+//Definitions
+#define MAX77650_debug true
+
+void MAX77650_diverged(MAX77650 &pmic, byte reg, byte expected, byte found)
+{
+  if (MAX77650_debug) {
+    Serial.print("Register 0x"); Serial.print(reg, HEX);
+    Serial.print(" diverged: expected 0x"); Serial.print(expected, HEX);
+    Serial.print(", found 0x"); Serial.println(found, HEX);
+  }
+}
+
+void setup(void)
+{
+  Serial.begin(115200);
+  MAX77650_init();
+
+  MAX77650_setTV_SBB0(0x14);          //SBB0 1.3V
+  MAX77650_setEN_SBB2(0b110);         //SBB2 on
+  MAX77650_setCHG_CC(0x27);           //fast-charge current 300mA
+  MAX77650_setCHG_EN(true);           //charger enabled
+
+  MAX77650_PMIC.setScrubber(4, MAX77650_diverged);
+}
+
+void loop(void)
+{
+  MAX77650_scrub();
+  delay(100);
+}
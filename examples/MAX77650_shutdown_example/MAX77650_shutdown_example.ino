@@ -0,0 +1,118 @@
+/**********************************************************************
+* Copyright (C) 2026 Maxim Integrated Products, Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+* 
+* Authors: 
+* Ole Dreessen; ole.dreessen@maximintegrated.com
+* 
+* Revisions:
+* 1.0.0       18.10.2026      initial code
+* 
+* 
+* The MAX77650/MAX77651 provide highly-integrated battery charging and 
+* power supply solutions for low-power wearable applications where size and efficiency 
+* are critical. Both devices feature a SIMO buck-boost regulator that provides three 
+* independently programmable power rails from a single inductor to minimize total solution 
+* size. A 150mA LDO provides ripple rejection for audio and other noise-sensitive applications. 
+* A highly configurable linear charger supports a wide range of Li+ battery capacities and 
+* includes battery temperature monitoring for additional safety (JEITA).
+*
+* The devices include other features such as current sinks for driving LED indicators and 
+* an analog multiplexer that switches several internal voltage and current signals to an 
+* external node for monitoring with an external ADC. A bidirectional I2C interface allows 
+* for configuring and checking the status of the devices. An internal on/off controller 
+* provides a controlled startup sequence for the regulators and provides supervisory 
+* functionality when the devices are on. Numerous factory programmable options allow the 
+* device to be tailored for many applications, enabling faster time to market.
+*
+* Ressources can be found at
+* https://www.maximintegrated.com/en/products/power/battery-management/MAX77650.html
+* https://www.maximintegrated.com/en/app-notes/index.mvp/id/6428
+* 
+* Orderly shutdown. The host holds the power with PWR_HLD. After the work is
+* done the sequencer writes the pending requests, switches the LEDs and the
+* LDO off, then the SIMO channels after 2ms, releases PWR_HLD and switches
+* the PMIC off by software. A dry run at start measures the duration of the
+* sequence without switching anything off.
+* 
+* Flow (this example will only work with connected battery and NO USB input!):
+* Press Power-On-Button
+*           v
+* Hold the power with PWR_HLD and configure the MAX77650
+*           v
+* Measure the shutdown sequence in a dry run
+*           v
+* Do some Application stuff
+*           v
+* Run the shutdown sequence
+* 
+**********************************************************************/
+
+//Pin Definitions
+#define MAX77650_PHLD 18   //Pin 18 -> connected to MAX77650 power hold input pin (A1)
+
+// Includes
+#include <Wire.h>
+#include <MAX77650-Arduino-Library.h>
+
+//Definitions
+#define MAX77650_debug true
+
+// Globals
+const byte shutdown_stages[2] = {
+  MAX77650_RAIL_LEDS | MAX77650_RAIL_LDO,                         //loads first
+  MAX77650_RAIL_SBB0 | MAX77650_RAIL_SBB1 | MAX77650_RAIL_SBB2    //then the SIMO channels
+};
+
+void setup(void)
+{
+  Serial.begin(115200);
+  MAX77650_shutdown_begin(MAX77650_PHLD, 2);   //holds the power-on state
+  MAX77650_shutdown_setSequence(shutdown_stages, 2);
+  if (!MAX77650_init() && MAX77650_debug) Serial.println("PMIC does not acknowledge");
+  MAX77650_setLED_FS1(0b01);
+  MAX77650_setEN_LED_MSTR(true);
+  unsigned long us = MAX77650_shutdown(true, true);   //dry run: same transactions, nothing switched off
+  if (MAX77650_debug) {
+    Serial.print("Shutdown sequence takes ");
+    Serial.print(us);
+    Serial.println("us");
+  }
+}
+
+void loop(void)
+{
+  //Do some stuff and goto power off again
+  for (byte i = 0; i < 32; i++) {
+    MAX77650_setBRT_LED1(i);
+    delay(50);
+  }
+  MAX77650_shutdown();
+}
@@ -0,0 +1,109 @@
+/**********************************************************************
+* Copyright (C) 2026 Maxim Integrated Products, Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+* 
+* Authors: 
+* Ole Dreessen; ole.dreessen@maximintegrated.com
+* 
+* Revisions:
+* 1.0.0       18.10.2026      initial code
+* 
+* 
+* The MAX77650/MAX77651 provide highly-integrated battery charging and 
+* power supply solutions for low-power wearable applications where size and efficiency 
+* are critical. Both devices feature a SIMO buck-boost regulator that provides three 
+* independently programmable power rails from a single inductor to minimize total solution 
+* size. A 150mA LDO provides ripple rejection for audio and other noise-sensitive applications. 
+* A highly configurable linear charger supports a wide range of Li+ battery capacities and 
+* includes battery temperature monitoring for additional safety (JEITA).
+*
+* The devices include other features such as current sinks for driving LED indicators and 
+* an analog multiplexer that switches several internal voltage and current signals to an 
+* external node for monitoring with an external ADC. A bidirectional I2C interface allows 
+* for configuring and checking the status of the devices. An internal on/off controller 
+* provides a controlled startup sequence for the regulators and provides supervisory 
+* functionality when the devices are on. Numerous factory programmable options allow the 
+* device to be tailored for many applications, enabling faster time to market.
+*
+* Ressources can be found at
+* https://www.maximintegrated.com/en/products/power/battery-management/MAX77650.html
+* https://www.maximintegrated.com/en/app-notes/index.mvp/id/6428
+* 
+* Thermal throttling. While the die of the PMIC is hot the charge current is
+* lowered and the LEDs are dimmed (level 1: TJAL1 or junction temperature
+* regulation), at TJAL2 also the radio rail SBB2 is lowered (level 2). The
+* settings are restored step by step once the alarms were clear for 10s.
+* 
+* Flow:
+* Initialize the PMIC and the IRQ pin
+*           v
+* Start the controller with the actions of both levels
+*           v
+* Service the interrupts and tick the controller
+* 
+**********************************************************************/
+
+// Includes
+#include <Wire.h>
+#include <MAX77650-Arduino-Library.h>
+
+//Definitions
+#define MAX77650_debug true
+#define MAX77650_IRQpin P2_3        //Pin 19 -> connected to MAX77650 IRQ output pin (C2)
+
+// Globals
+const MAX77650_throttle_level actions[MAX77650_THROTTLE_LEVELS] = {
+  {MAX77650_CHG_CC_mA(75), 50, {0xFF, 0xFF, 0xFF}},                       //level 1: 75mA charge current, LEDs at half brightness
+  {MAX77650_CHG_CC_mA(15), 25, {0xFF, 0xFF, MAX77650_TV_SBB2_mV(3000)}}   //level 2: 15mA, quarter brightness, SBB2 at 3.0V
+};
+
+void report(byte level)
+{
+  if (MAX77650_debug) {
+    Serial.print("thermal throttling level ");
+    Serial.println(level);
+  }
+}
+
+void setup(void)
+{
+  Serial.begin(115200);
+  MAX77650_init();
+  MAX77650_throttle_begin(actions, 10000, report);
+  pinMode(MAX77650_IRQpin, INPUT_PULLUP);
+  attachInterrupt(MAX77650_IRQpin, MAX77650_IRQ, FALLING);
+}
+
+void loop(void)
+{
+  if (MAX77650_interruptPending())
+   MAX77650_serviceInterrupts();
+  MAX77650_throttle_tick();
+}
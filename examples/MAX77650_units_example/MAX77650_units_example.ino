@@ -0,0 +1,103 @@
+/**********************************************************************
+* Copyright (C) 2026 Maxim Integrated Products, Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+* 
+* Authors: 
+* Ole Dreessen; ole.dreessen@maximintegrated.com
+* 
+* Revisions:
+* 1.0.0       18.10.2026      initial code
+* 
+* 
+* The MAX77650/MAX77651 provide highly-integrated battery charging and 
+* power supply solutions for low-power wearable applications where size and efficiency 
+* are critical. Both devices feature a SIMO buck-boost regulator that provides three 
+* independently programmable power rails from a single inductor to minimize total solution 
+* size. A 150mA LDO provides ripple rejection for audio and other noise-sensitive applications. 
+* A highly configurable linear charger supports a wide range of Li+ battery capacities and 
+* includes battery temperature monitoring for additional safety (JEITA).
+*
+* The devices include other features such as current sinks for driving LED indicators and 
+* an analog multiplexer that switches several internal voltage and current signals to an 
+* external node for monitoring with an external ADC. A bidirectional I2C interface allows 
+* for configuring and checking the status of the devices. An internal on/off controller 
+* provides a controlled startup sequence for the regulators and provides supervisory 
+* functionality when the devices are on. Numerous factory programmable options allow the 
+* device to be tailored for many applications, enabling faster time to market.
+*
+* Ressources can be found at
+* https://www.maximintegrated.com/en/products/power/battery-management/MAX77650.html
+* https://www.maximintegrated.com/en/app-notes/index.mvp/id/6428
+* 
+* Units. The rails and the LED are configured in mV, mA, ms and %; the
+* conversions to register codes are done by the compiler (MAX77650_CODE), a
+* value out of range does not compile. The settings are read back and printed
+* in the same units with the inverse converters.
+* 
+* Flow:
+* Initialize the PMIC
+*           v
+* Configure SBB0, LDO and LED0 in physical units
+*           v
+* Read back and print in physical units
+* 
+**********************************************************************/
+
+// Includes
+#include <Wire.h>
+#include <MAX77650-Arduino-Library.h>
+
+//Definitions
+#define MAX77650_debug true
+
+void setup(void)
+{
+  Serial.begin(115200);
+  MAX77650_init();
+  MAX77650_setIP_SBB0(MAX77650_CODE(MAX77650_IP_SBB_mA(500)));     //Limit output of SBB0 to 500mA
+  MAX77650_setTV_SBB0(MAX77650_CODE(MAX77650_TV_SBB0_mV(1800)));   //Set output Voltage of SBB0 to 1.8V
+  MAX77650_setTV_LDO(MAX77650_CODE(MAX77650_TV_LDO_mV(2500)));     //Set output Voltage of the LDO to 2.5V
+  MAX77650_setP_LED0(MAX77650_CODE(MAX77650_P_LED_ms(1024)));      //LED red: blink every 1024ms
+  MAX77650_setD_LED0(MAX77650_CODE(MAX77650_D_LED_percent(25)));   //LED red: on for 25% of the period
+  //MAX77650_setTV_SBB0(MAX77650_CODE(MAX77650_TV_SBB0_mV(3300))); //does not compile: SBB0 ends at 2.375V
+
+  if (MAX77650_debug) {
+    Serial.print("SBB0: "); Serial.print(MAX77650_TV_SBB0_to_mV(MAX77650_getTV_SBB0()));
+    Serial.print("mV, peak "); Serial.print(MAX77650_IP_SBB_to_mA(MAX77650_getIP_SBB0()));
+    Serial.print("mA; LDO: "); Serial.print(MAX77650_TV_LDO_to_mV(MAX77650_getTV_LDO()));
+    Serial.print("mV; LED0 period: "); Serial.print(MAX77650_P_LED_to_ms(MAX77650_getP_LED0()));
+    Serial.print("ms, duty: "); Serial.print(MAX77650_D_LED_to_permille(MAX77650_getD_LED0()) / 10.0);
+    Serial.println("%");
+  }
+}
+
+void loop(void)
+{
+}
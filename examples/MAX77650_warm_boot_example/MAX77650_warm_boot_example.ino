@@ -0,0 +1,115 @@
+/**********************************************************************
+* Copyright (C) 2026 Maxim Integrated Products, Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+* 
+* Authors: 
+* Ole Dreessen; ole.dreessen@maximintegrated.com
+* 
+* Revisions:
+* 1.0.0       18.10.2026      initial code
+* 
+* 
+* The MAX77650/MAX77651 provide highly-integrated battery charging and 
+* power supply solutions for low-power wearable applications where size and efficiency 
+* are critical. Both devices feature a SIMO buck-boost regulator that provides three 
+* independently programmable power rails from a single inductor to minimize total solution 
+* size. A 150mA LDO provides ripple rejection for audio and other noise-sensitive applications. 
+* A highly configurable linear charger supports a wide range of Li+ battery capacities and 
+* includes battery temperature monitoring for additional safety (JEITA).
+*
+* The devices include other features such as current sinks for driving LED indicators and 
+* an analog multiplexer that switches several internal voltage and current signals to an 
+* external node for monitoring with an external ADC. A bidirectional I2C interface allows 
+* for configuring and checking the status of the devices. An internal on/off controller 
+* provides a controlled startup sequence for the regulators and provides supervisory 
+* functionality when the devices are on. Numerous factory programmable options allow the 
+* device to be tailored for many applications, enabling faster time to market.
+*
+* Ressources can be found at
+* https://www.maximintegrated.com/en/products/power/battery-management/MAX77650.html
+* https://www.maximintegrated.com/en/app-notes/index.mvp/id/6428
+* 
+* Warm boot: after a reset of the µC the PMIC stays powered and keeps its
+* registers. The configuration snapshot survives the reset in RAM which is not
+* initialized by the startup code (.noinit); restoring it costs a few burst
+* reads and writes only the registers which differ.
+* 
+* Flow:
+* Snapshot valid (warm boot)?
+*    yes: restoreSnapshot -> burst reads, writes of the differences only
+*    no:  apply the full configuration and take a snapshot
+* 
+**********************************************************************/
+
+// Includes
+#include <Wire.h>
+#include <MAX77650-Arduino-Library.h>
+
+//Definitions
+#define MAX77650_debug true
+
+// Globals
+MAX77650_snapshot MAX77650_retained __attribute__((section(".noinit")));   //not cleared by a reset of the µC
+
+void setup(void)
+{
+  Serial.begin(115200);
+  MAX77650_init();
+
+  int bursts = MAX77650_restoreSnapshot(MAX77650_retained);
+  if (bursts >= 0) {
+    if (MAX77650_debug) Serial.print("Warm boot, registers restored with burst writes: ");
+    if (MAX77650_debug) Serial.println(bursts);
+  }
+  else {
+    //cold boot (or a snapshot of another PMIC): full configuration
+    if (MAX77650_debug) Serial.println("Cold boot, full configuration");
+    MAX77650_setSBIA_LPM(false);        //Main Bias in normal Mode
+    MAX77650_setnEN_MODE(false);        //On/Off-Button in push-button-mode
+    MAX77650_setDBEN_nEN(true);         //nEN input debounce time 30ms
+    MAX77650_setTV_SBB0(0x14);          //SBB0 1.3V
+    MAX77650_setEN_SBB2(0b110);         //SBB2 on
+    MAX77650_setLED_FS0(0b01);          //LED red: 6.4mA full scale
+    MAX77650_setP_LED0(0b1111);         //LED red: always on
+    MAX77650_setD_LED0(0b1111);
+    MAX77650_setEN_LED_MSTR(true);      //LEDs Master enable
+    if (!MAX77650_takeSnapshot(MAX77650_retained) && MAX77650_debug) Serial.println("Snapshot failed");
+  }
+}
+
+void loop(void)
+{
+  //changes of the configuration are kept in the snapshot for the next warm boot
+  static byte brightness = 0;
+  brightness = (brightness + 1) & 0b11111;
+  MAX77650_setBRT_LED0(brightness);
+  if (brightness == 0) MAX77650_takeSnapshot(MAX77650_retained);
+  delay(100);
+}
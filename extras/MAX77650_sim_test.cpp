@@ -0,0 +1,154 @@
+/**********************************************************************
+* Copyright (C) 2026 Maxim Integrated Products, Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* 
+* Authors: 
+* Ole Dreessen; ole.dreessen@maximintegrated.com
+* 
+* Revisions:
+* 1.0.0       18.10.2026      initial code
+* 
+* 
+* Host test of the driver against MAX77650_sim_transport: runs the checks
+* below and prints each result; the exit code is the number of failed checks.
+* 
+* Build (from this folder):
+* g++ -std=gnu++11 -I.. MAX77650_sim_test.cpp ../MAX77650-Arduino-Library.cpp -o MAX77650_sim_test
+* 
+* Usage:
+* MAX77650_sim_test
+* 
+**********************************************************************/
+
+// Includes
+#include <stdio.h>
+#include "MAX77650-Arduino-Library.h"
+
+static int failures = 0;
+
+static void check(const char *name, boolean passed){
+  printf("%-60s %s\n", name, passed ? "ok" : "FAILED");
+  if (!passed)
+   failures++;
+}
+
+//a write the PMIC does not take (BOK of CNFG_GLBL is read-only) fails its verification every time, 
+//not only until the rejected value is in the shadow
+static void test_rejected_write(void){
+  MAX77650_sim_transport sim;
+  MAX77650 pmic(sim);
+  pmic.begin();
+  const MAX77650_field BOK = {MAX77650_CNFG_GLBL_ADDR, 0b00000001, 7};
+  check("setField: rejected write fails", !pmic.setField(BOK, 1));
+  unsigned long transactions = sim.transactions;
+  check("setField: rejected write fails again", !pmic.setField(BOK, 1));
+  check("setField: repeated write goes to the bus", sim.transactions != transactions);
+  check("setField: accepted write succeeds", pmic.setField(MAX77650_FIELD_BRT_LED0, 7) && sim.peek(MAX77650_CNFG_LED0_A_ADDR) == 7);
+}
+
+//a simulated PMIC whose reads fail, e.g. while the bus is stuck
+class MAX77650_dead_transport : public MAX77650_sim_transport {
+  public:
+    boolean down = false;
+    int read(byte addr, byte ADDR, byte *data, byte len){
+      return down ? MAX77650_ERR_NACK_ADDR : MAX77650_sim_transport::read(addr, ADDR, data, len);
+    }
+};
+
+//the charge controller does not start from a failed read, nor mask the other charger interrupts
+static void test_chargeController_bus_error(void){
+  MAX77650_dead_transport sim;
+  MAX77650_PMIC.setTransport(sim);
+  MAX77650_PMIC.setRetries(0, 10, 1000);
+  sim.poke(MAX77650_INT_M_CHG_ADDR, 0b01111111);
+  sim.down = true;
+  check("chargeController: begin fails on a bus error", !MAX77650_chargeController_begin(0x27, 0x04, 50));
+  check("chargeController: INT_M_CHG untouched", sim.peek(MAX77650_INT_M_CHG_ADDR) == 0b01111111);
+  sim.down = false;
+  check("chargeController: begin succeeds", MAX77650_chargeController_begin(0x27, 0x04, 50));
+  check("chargeController: only TJ_REG_I and CHGIN_CTRL_I unmasked", 
+        sim.peek(MAX77650_INT_M_CHG_ADDR) == (0b01111111 & ~(MAX77650_INT_CHG_TJ_REG_I | MAX77650_INT_CHG_CHGIN_CTRL_I)));
+  MAX77650_chargeController_end();
+}
+
+//a charger profile applied by the JEITA supervisor does not lift the ceiling of the application
+static void test_chargeController_ceiling(void){
+  MAX77650_sim_transport sim;
+  MAX77650_PMIC.setTransport(sim);
+  MAX77650_init();
+  static const MAX77650_charger_profile fast = MAX77650_charger_profile().CHG_CC_mA(300).CHG_EN(true);
+  static const MAX77650_charger_profile *const zones[MAX77650_THM_ZONES] = {&fast, &fast, &fast, &fast, &fast, &fast};
+  check("chargeController: begin with ceiling 0x10", MAX77650_chargeController_begin(0x10, 0x04, 1));
+  check("chargeController: JEITA supervisor started", MAX77650_jeita_begin(zones));
+  delay(5);
+  MAX77650_chargeController_tick();
+  check("chargeController: CHG_CC kept at the ceiling", MAX77650_chargeController_getCHG_CC() <= 0x10 && MAX77650_getCHG_CC() <= 0x10);
+  MAX77650_jeita_end();
+  MAX77650_chargeController_end();
+}
+
+//with the charge-current controller running, a throttled CHG_CC is not raised back by the controller
+static void test_throttle_chargeController(void){
+  MAX77650_sim_transport sim;
+  MAX77650_PMIC.setTransport(sim);
+  MAX77650_init();
+  MAX77650_setCHG_CC(MAX77650_CHG_CC_mA(150));
+  static const MAX77650_throttle_level table[MAX77650_THROTTLE_LEVELS] = {
+    {MAX77650_CHG_CC_mA(30), 100, {0xFF, 0xFF, 0xFF}}, 
+    {MAX77650_CHG_CC_mA(15), 100, {0xFF, 0xFF, 0xFF}}};
+  MAX77650_chargeController_begin(0x27, 0x04, 1);
+  MAX77650_throttle_begin(table, 10);
+  sim.poke(MAX77650_INT_GLBL_ADDR, MAX77650_INT_GLBL_TJAL1_R);
+  sim.poke(MAX77650_STAT_GLBL_ADDR, 0b00001000);
+  MAX77650_IRQ();
+  MAX77650_serviceInterrupts();
+  check("throttle: level 1 lowers CHG_CC", MAX77650_getCHG_CC() <= MAX77650_CHG_CC_mA(30));
+  for (byte i = 0; i < 5; i++){
+    delay(2);
+    MAX77650_chargeController_tick();
+  }
+  check("throttle: controller keeps CHG_CC throttled", MAX77650_throttle_getLevel() == 1 && MAX77650_getCHG_CC() <= MAX77650_CHG_CC_mA(30));
+  sim.poke(MAX77650_STAT_GLBL_ADDR, 0);
+  MAX77650_throttle_end();
+  for (byte i = 0; i < 5; i++){
+    delay(2);
+    MAX77650_chargeController_tick();
+  }
+  check("throttle: controller raises CHG_CC after the throttling", MAX77650_getCHG_CC() > MAX77650_CHG_CC_mA(30));
+  MAX77650_chargeController_end();
+}
+
+int main(void){
+  test_rejected_write();
+  test_chargeController_bus_error();
+  test_chargeController_ceiling();
+  test_throttle_chargeController();
+  printf("%d check(s) failed\n", failures);
+  return failures;
+}
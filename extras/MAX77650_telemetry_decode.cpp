@@ -0,0 +1,130 @@
+/**********************************************************************
+* Copyright (C) 2026 Maxim Integrated Products, Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+* 
+* Authors: 
+* Ole Dreessen; ole.dreessen@maximintegrated.com
+* 
+* Revisions:
+* 1.0.0       18.10.2026      initial code
+* 
+* 
+* Host tool decoding a stream of MAX77650_telemetry_frame frames (see 
+* MAX77650-Arduino-Library.h) into CSV, one line per frame. The stream may 
+* start inside a frame and may contain other bytes: frames are found by their 
+* header and CRC. Delta frames following a lost or broken frame are counted as 
+* dropped until the next key frame.
+* 
+* Build (from this folder):
+* g++ -std=gnu++11 -I.. MAX77650_telemetry_decode.cpp ../MAX77650-Arduino-Library.cpp -o MAX77650_telemetry_decode
+* 
+* Usage:
+* MAX77650_telemetry_decode [-s] [stream.bin]
+*   -s  prints only the summary
+*   reads stdin without a file
+* 
+**********************************************************************/
+
+// Includes
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "MAX77650-Arduino-Library.h"
+
+static boolean intact(const byte *frame){ //Returns whether the frame has a valid header and CRC, whatever the decoder state
+  MAX77650_telemetry probe = {};
+  probe.synced = true;
+  probe.sequence = (frame[0] - 1) & 0b00000111;
+  return MAX77650_telemetry_decode(frame, probe);
+}
+
+int main(int argc, char **argv){
+  boolean summary = false;
+  const char *path = NULL;
+  for (int i = 1; i < argc; i++){
+    if (!strcmp(argv[i], "-s"))
+     summary = true;
+    else if (argv[i][0] == '-'){
+      fprintf(stderr, "usage: %s [-s] [stream.bin]\n", argv[0]);
+      return 2;
+    }
+    else
+     path = argv[i];
+  }
+  FILE *f = path ? fopen(path, "rb") : stdin;
+  if (!f){
+    perror(path);
+    return 2;
+  }
+  std::vector<byte> stream;
+  byte chunk[256];
+  size_t n;
+  while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0)
+   stream.insert(stream.end(), chunk, chunk + n);
+  if (path)
+   fclose(f);
+
+  MAX77650_telemetry state = {};
+  unsigned long frames = 0, keys = 0, dropped = 0, skipped = 0, irqs = 0;
+  if (!summary)
+   printf("frame,key,seq,STAT_CHG_A,STAT_CHG_B,STAT_GLBL,INT_GLBL,INT_CHG,irqs,amux0,amux1,amux2,amux3\n");
+  unsigned int pos = 0;
+  while (pos + MAX77650_TELEMETRY_FRAME <= stream.size()){
+    const byte *frame = &stream[pos];
+    if (!intact(frame)){
+      pos++;
+      skipped++;   //a lost frame is found by the sequence number
+      continue;
+    }
+    pos += MAX77650_TELEMETRY_FRAME;
+    if (!MAX77650_telemetry_decode(frame, state)){
+      dropped++;
+      continue;
+    }
+    frames++;
+    keys += state.key;
+    irqs += state.irqs;
+    if (summary)
+     continue;
+    printf("%lu,%u,%u,0x%02X,0x%02X,0x%02X,0x%02X,0x%02X,%u", frames, state.key, state.sequence, state.STAT_CHG_A, 
+           state.STAT_CHG_B, state.STAT_GLBL, state.INT_GLBL, state.INT_CHG, state.irqs);
+    for (byte i = 0; i < MAX77650_TELEMETRY_CHANNELS; i++)
+     printf(",%d", state.amux[i]);
+    printf("\n");
+  }
+  skipped += stream.size() - pos;
+
+  FILE *out = summary ? stdout : stderr;
+  fprintf(out, "frames decoded:       %lu (%lu key frames)\n", frames, keys);
+  fprintf(out, "frames dropped:       %lu (delta frames without their previous frame)\n", dropped);
+  fprintf(out, "bytes skipped:        %lu\n", skipped);
+  fprintf(out, "interrupt services:   %lu\n", irqs);
+  return 0;
+}
@@ -0,0 +1,177 @@
+/**********************************************************************
+* Copyright (C) 2026 Maxim Integrated Products, Inc., All Rights Reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a
+* copy of this software and associated documentation files (the "Software"),
+* to deal in the Software without restriction, including without limitation
+* the rights to use, copy, modify, merge, publish, distribute, sublicense,
+* and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included
+* in all copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+* IN NO EVENT SHALL MAXIM INTEGRATED BE LIABLE FOR ANY CLAIM, DAMAGES
+* OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+* OTHER DEALINGS IN THE SOFTWARE.
+*
+* Except as contained in this notice, the name of Maxim Integrated
+* Products, Inc. shall not be used except as stated in the Maxim Integrated
+* Products, Inc. Branding Policy.
+*
+* The mere transfer of this software does not imply any licenses
+* of trade secrets, proprietary technology, copyrights, patents,
+* trademarks, maskwork rights, or any other form of intellectual
+* property whatsoever. Maxim Integrated Products, Inc. retains all
+* ownership rights.
+* 
+* Authors: 
+* Ole Dreessen; ole.dreessen@maximintegrated.com
+* 
+* Revisions:
+* 1.0.0       18.10.2026      initial code
+* 1.0.1       18.10.2026      simulated PMIC at the address of the trace, failed simulated transfers counted
+* 
+* 
+* Host tool replaying a trace of MAX77650_trace (see MAX77650-Arduino-Library.h)
+* into MAX77650_sim_transport. Writes are applied to the simulated PMIC, reads
+* are compared with the values recorded in the field; a differing read is
+* reported and its recorded values are loaded into the simulation, so the
+* following read-modify-writes start from the state of the field. The simulated
+* PMIC answers at the address of the first record unless -a sets one; transfers
+* it does not take (e.g. to another address) are counted, not compared.
+* 
+* Build (from this folder):
+* g++ -std=gnu++11 -I.. MAX77650_trace_replay.cpp ../MAX77650-Arduino-Library.cpp -o MAX77650_trace_replay
+* 
+* Usage:
+* MAX77650_trace_replay [-v] [-t] [-a address] trace.bin
+*   -v  prints every record
+*   -t  keeps the recorded time between the transfers
+*   -a  I2C address of the simulated PMIC, e.g. 0x40; default: the one of the first record
+* 
+**********************************************************************/
+
+// Includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "MAX77650-Arduino-Library.h"
+
+static void print_record(const MAX77650_trace_record &rec, unsigned long long at_us){
+  printf("%12llu us  +%-8lu %s 0x%02X reg 0x%02X len %-2u %6lu us ", at_us, rec.delta_us, rec.write ? "W" : "R", 
+         rec.addr, rec.reg, rec.len, rec.duration_us);
+  if (!rec.data){
+    printf(" failed, error %u\n", rec.status);
+    return;
+  }
+  for (byte i = 0; i < rec.len; i++)
+   printf(" %02X", rec.data[i]);
+  printf("\n");
+}
+
+int main(int argc, char **argv){
+  boolean verbose = false, timing = false;
+  int address = -1;
+  const char *path = NULL;
+  for (int i = 1; i < argc; i++){
+    if (!strcmp(argv[i], "-v"))
+     verbose = true;
+    else if (!strcmp(argv[i], "-t"))
+     timing = true;
+    else if (!strcmp(argv[i], "-a") && i + 1 < argc)
+     address = strtol(argv[++i], NULL, 0);
+    else
+     path = argv[i];
+  }
+  if (!path || address > 0x7F){
+    fprintf(stderr, "usage: %s [-v] [-t] [-a address] trace.bin\n", argv[0]);
+    return 2;
+  }
+  FILE *f = fopen(path, "rb");
+  if (!f){
+    perror(path);
+    return 2;
+  }
+  std::vector<byte> trace;
+  byte chunk[256];
+  size_t n;
+  while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0)
+   trace.insert(trace.end(), chunk, chunk + n);
+  fclose(f);
+
+  if (address < 0){
+    MAX77650_trace_record first;
+    address = MAX77650_trace_decode(trace.data(), trace.size(), first) ? first.addr : MAX77650_ADDR;
+  }
+  MAX77650_sim_transport sim(address);
+  unsigned long records = 0, reads = 0, writes = 0, failed = 0, rejected = 0, mismatches = 0, bytes = 0, worst_us = 0;
+  unsigned long long at_us = 0, bus_us = 0;
+  unsigned long start = micros();
+  unsigned int pos = 0;
+  while (pos < trace.size()){
+    MAX77650_trace_record rec;
+    unsigned int len = MAX77650_trace_decode(&trace[pos], trace.size() - pos, rec);
+    if (!len){
+      fprintf(stderr, "truncated record at byte %u\n", pos);
+      break;
+    }
+    pos += len;
+    records++;
+    at_us += rec.delta_us;
+    bus_us += rec.duration_us;
+    if (rec.duration_us > worst_us)
+     worst_us = rec.duration_us;
+    if (timing)
+     delayMicroseconds(rec.delta_us);
+    if (verbose)
+     print_record(rec, at_us);
+    if (!rec.data){
+      failed++;
+      continue;
+    }
+    bytes += rec.len;
+    int retval = 0;
+    if (rec.write){
+      writes++;
+      if ((retval = sim.write(rec.addr, rec.reg, rec.data, rec.len)) != 0){
+        rejected++;
+        if (verbose)
+         printf("%12s not taken by the simulation, error %d\n", "", retval);
+      }
+      continue;
+    }
+    reads++;
+    byte live[MAX77650_TRACE_MAX_DATA];
+    if ((retval = sim.read(rec.addr, rec.reg, live, rec.len)) != 0){
+      rejected++;   //nothing read to compare
+      if (verbose)
+       printf("%12s not taken by the simulation, error %d\n", "", retval);
+      continue;
+    }
+    for (byte i = 0; i < rec.len; i++){
+      if (live[i] == rec.data[i])
+       continue;
+      mismatches++;
+      if (verbose)
+       printf("%12s reg 0x%02X: field 0x%02X, simulation 0x%02X\n", "", rec.reg + i, rec.data[i], live[i]);
+      sim.poke(rec.reg + i, rec.data[i]);
+    }
+  }
+  unsigned long replay_us = micros() - start;
+
+  printf("simulated PMIC:       0x%02X\n", address);
+  printf("records:              %lu (%lu reads, %lu writes, %lu failed)\n", records, reads, writes, failed);
+  printf("not simulated:        %lu transfers\n", rejected);
+  printf("data bytes:           %lu\n", bytes);
+  printf("recorded span:        %llu us\n", at_us);
+  printf("recorded bus time:    %llu us (worst transfer %lu us)\n", bus_us, worst_us);
+  printf("reads differing:      %lu registers\n", mismatches);
+  printf("replay time:          %lu us\n", replay_us);
+  return rejected ? 1 : 0;
+}